@@ -18,6 +18,10 @@
 #include <stdint.h>
 #include "mpfs_hal/mss_hal.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
+#include "logbin.h"
+#include "logtx.h"
+#include "tvs.h"
+#include "hwerr.h"
 
 #ifndef MPFS_HAL_SHARED_MEM_ENABLED
 #endif
@@ -27,16 +31,109 @@ typedef struct HART_SHARED_DATA_
     uint64_t init_marker;
     volatile long mutex_uart0;
     mss_uart_instance_t *g_mss_uart0_lo;
+    mss_uart_instance_t *g_mss_uart1_lo;    /* telemetry (LOG_TELEMETRY_UART1), NULL: UART0 */
 } HART_SHARED_DATA;
 
 
 #define LOG_MSG_SIZE        1024
-#define BUFFER_DEPTH        1
-#define LOG_BUFFER_SIZE     LOG_MSG_SIZE * BUFFER_DEPTH
+#define LOG_RING_HARTS      4       /* HART1..HART4, one log ring each */
+#define LOG_RING_SIZE       2048    /* bytes per ring, power of two    */
+#define LOG_ENTRY_RECORD    0x8000  /* ring entry header: binary record, framed by the moncore */
+#define LOG_EVENT_QUEUE_SIZE 64    /* error events, power of two      */
+#define LOG_BURST_SLOTS     4       /* error bursts coalesced at once  */
+#define LOG_BURST_SYNDROMES 4       /* distinct syndromes per burst    */
+#define LOG_BURST_TIMEOUT_MS 500    /* a burst is sent this long after its first error, budget allowing */
+#define LOG_ERROR_BUDGET    8       /* [BENCHMARK_ERROR] lines (bursts) per LOG_ERROR_PERIOD_MS       */
+#define LOG_ERROR_PERIOD_MS 5000
+
+/* Log ring of one appcore, single consumer: head and overflow are written by the tasks
+ * of the owning appcore, one at a time inside a critical section (log_ring_write()),
+ * tail, overflow_reported and corrupted only by the moncore. Indexes run freely and
+ * are masked on access. */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflow;         /* messages dropped because the ring was full */
+    uint32_t overflow_reported;
+    uint32_t corrupted;                 /* bad entry headers skipped by the moncore   */
+    uint32_t corrupted_reported;
+    uint8_t data[LOG_RING_SIZE];
+} log_ring_t;
+
+/* Error event pushed from a workload loop by log_error_event(). The slot of queue
+ * position pos is free when seq is pos & ~(LOG_EVENT_QUEUE_SIZE - 1) and holds an event
+ * when it is that value + 1, so a zeroed queue is empty and needs no initialisation. */
+typedef struct
+{
+    volatile uint32_t seq;
+    uint8_t hart;
+    uint32_t errnum;
+    uint32_t itr;
+    uint32_t syndrome[2];
+    uint64_t stamp;                     /* mcycle when the error was seen              */
+    const char *name;                   /* workload name (literal)                     */
+    const char *syndrome_fmt;           /* e.g. " seed=0x%08x" for syndrome, or NULL   */
+} log_event_t;
+
+/* Multi-producer (any hart or task), single-consumer (moncore) event queue */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflow;         /* events dropped because the queue was full */
+    uint32_t overflow_reported;
+    log_event_t slot[LOG_EVENT_QUEUE_SIZE];
+} log_event_queue_t;
+
+/* 1: results, errors, TVS readings and lifecycle markers are sent as framed binary records
+ * (see logbin.h), decoded back to this text by instrumentation/scripts/monitor.py */
+#define LOG_BINARY          0
+
+/* 1 (needs LOG_BINARY): log_from_appcore() and log_from_appcore_noheader() send a format ID
+ * and their raw arguments, formatting is done by monitor.py with the ELF (--elf). The format
+ * must be a string literal and pointers for %p must be cast to (void *). */
+#define LOG_DEFERRED        0
+
+/* 1: the moncore queues its UART output (logtx.h) and the MMUART interrupt sends it, instead
+ * of polling the UART with mutex_uart0 held. HART0 must enable the MMUART0 interrupt in the
+ * PLIC and call forward_log_from_appcore() whenever it wakes up, from thread context with
+ * interrupts enabled: a write into a full transmit ring waits for that interrupt. */
+#define LOG_TX_ASYNC        0
+
+/* N > 0 (needs LOG_BINARY): the results of a cycle are sent in full every N cycles only, the
+ * other cycles send what changed since the previous report. monitor.py rebuilds the full
+ * block, it needs one full report first (up to N cycles after it starts). */
+#define LOG_RESULTS_KEYFRAME 0
+#define LOG_RESULTS_MAX     64      /* largest workload count kept for delta reports */
+
+/* 1 (needs LOG_BINARY): results, error and TVS records are sent on MMUART1, lifecycle and
+ * other text stays on UART0. HART0 must initialise MMUART1 and set g_mss_uart1_lo (and, with
+ * LOG_TX_ASYNC, enable its interrupt too). Both UARTs are written by the moncore only, under
+ * mutex_uart0, each with its own logtx queue. */
+#define LOG_TELEMETRY_UART1 0
+
+#define LOG_CHANNEL_CONSOLE     0   /* UART0 */
+#define LOG_CHANNEL_TELEMETRY   1   /* UART1 with LOG_TELEMETRY_UART1, otherwise UART0 */
+#define LOG_CHANNELS            2
+
+/* 1: the TVS sensor is read every TVS_SAMPLE_MS from a timer (tvs.h) and each [TVS] report
+ * gives the min/mean/max and limit crossings of the readings since the previous one, instead
+ * of one reading per cycle. Singlecore uses the HART1 SysTick (HART1_TICK_RATE_MS in
+ * mss_sw_config.h must divide TVS_SAMPLE_MS), FreeRTOS a software timer. */
+#define TVS_SAMPLER         0
+#define TVS_SAMPLE_MS       10
+
+/* 1: L2 cache ECC counters and bus error units (hwerr.h) are read at the end of every cycle,
+ * sources that changed are reported as [HWERR] lines (corrected/uncorrected since the
+ * previous cycle, BEU cause, error address) just before the results of the cycle. */
+#define HWERR_COLLECT       0
 
 /**
  * extern variables
  */
+extern log_ring_t log_ring[LOG_RING_HARTS];
+extern log_event_queue_t log_event_queue;
 
 
 
@@ -48,5 +145,41 @@ void log_from_appcore(HART_SHARED_DATA *h_shared, const char *fmt, ...);
 void forward_log_from_appcore(HART_SHARED_DATA *h_shared);
 void log_from_moncore_noheader_nospinlock(const char *fmt, ...);
 void log_from_moncore(HART_SHARED_DATA *h_shared, const char *fmt, ...); 
+void log_record_from_appcore(HART_SHARED_DATA *h_shared, logbin_record_t *rec);
+void log_results_from_appcore(HART_SHARED_DATA *h_shared, uint32_t cycle, uint8_t n, const uint32_t *errors, const uint32_t *execs, const uint32_t *runtime);
+void log_tvs_from_appcore(HART_SHARED_DATA *h_shared);
+void log_hwerr_from_appcore(HART_SHARED_DATA *h_shared);
+void log_error_event(const char *name, uint32_t errnum, uint32_t itr, const char *syndrome_fmt, uint32_t syndrome0, uint32_t syndrome1);
+
+#if (LOG_RESULTS_KEYFRAME > 0) && (LOG_BINARY != 1)
+#error "LOG_RESULTS_KEYFRAME needs LOG_BINARY"
+#endif
+
+#if (LOG_TELEMETRY_UART1 == 1) && (LOG_BINARY != 1)
+#error "LOG_TELEMETRY_UART1 needs LOG_BINARY"
+#endif
+
+#if (LOG_DEFERRED == 1)
+#if (LOG_BINARY != 1)
+#error "LOG_DEFERRED needs LOG_BINARY"
+#endif
+
+/* Format strings are kept in their own section, a string's offset in it is its ID */
+extern const char __start_logfmt[];
+
+#define LOG_TRACE(h_shared, header, fmt, ...)                                               \
+    do                                                                                      \
+    {                                                                                       \
+        static const char logfmt_[] __attribute__((section("logfmt"), used)) = fmt;         \
+        logbin_record_t rec_;                                                               \
+        logbin_begin(&rec_, LOGBIN_TRACE, read_csr(mhartid));                               \
+        logbin_put_uint(&rec_, ((uint32_t)(logfmt_ - __start_logfmt) << 1) | (header));     \
+        LOGBIN_PUT_ARGS(&rec_, ##__VA_ARGS__);                                              \
+        log_record_from_appcore((h_shared), &rec_);                                         \
+    } while (0)
+
+#define log_from_appcore(h_shared, fmt, ...)            LOG_TRACE(h_shared, 1, fmt, ##__VA_ARGS__)
+#define log_from_appcore_noheader(h_shared, fmt, ...)   LOG_TRACE(h_shared, 0, fmt, ##__VA_ARGS__)
+#endif
 
 #endif /* COMMON_H_ */
@@ -15,6 +15,8 @@
    there is variation between platforms and architectures. */
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include "beebsc.h"
 
@@ -22,12 +24,155 @@
 
 static long int seed = 0;
 
-/* Heap records and sane initial values */
+/* BEEBS heap blocks.
 
-static void *heap_ptr = NULL;
-static void *heap_end = NULL;
-static size_t heap_requested = 0;
+   Each block is a header, a payload of a fixed size class and a tail canary.
+   The header guard word is derived from the size word and the block
+   address, so a corrupted header or a pointer that was never returned by
+   the allocator is detected. Freed blocks are kept in one list per size
+   class, so allocation and free are O(1) and deterministic. */
 
+struct heap_block_beebs
+{
+  uint32_t size;		/* payload size, HEAP_ALLOCATED if in use */
+  uint32_t guard;		/* HEAP_CANARY ^ size ^ address */
+};
+
+#define HEAP_ALIGN 8
+#define HEAP_ALLOCATED 1U
+#define HEAP_CANARY 0x5AFEB10CU
+#define HEAP_TAIL_CANARY 0xDEADBEEFU
+#define HEAP_HEADER_SIZE sizeof (struct heap_block_beebs)
+#define HEAP_TAIL_SIZE HEAP_ALIGN
+
+/* Classes are 8 byte steps up to HEAP_SMALL_MAX, powers of two above */
+#define HEAP_SMALL_MAX 128
+#define HEAP_SMALL_CLASSES (HEAP_SMALL_MAX / HEAP_ALIGN)
+#define HEAP_CLASSES (HEAP_SMALL_CLASSES + 24)
+
+/* Heap records, kept at the start of the caller's heap array so that
+   workloads running concurrently each have their own */
+
+struct heap_arena_beebs
+{
+  char *ptr;			/* first byte never allocated */
+  char *end;
+  heap_error_beebs_t error;
+  struct heap_block_beebs *free[HEAP_CLASSES];
+};
+
+#define HEAP_ARENA_SIZE \
+  ((sizeof (struct heap_arena_beebs) + HEAP_ALIGN - 1) & ~(size_t) (HEAP_ALIGN - 1))
+
+/* Heap used by malloc_beebs and friends: the last one initialised. Until
+   init_heap_beebs is called it is an empty arena, so allocations fail with
+   HEAP_ERR_EXHAUSTED and frees with HEAP_ERR_BAD_POINTER. */
+
+static struct heap_arena_beebs heap_none __attribute__ ((aligned (HEAP_ALIGN)));
+static void *heap_current = &heap_none;
+
+static struct heap_arena_beebs *
+heap_arena (void *heap)
+{
+  uintptr_t start = ((uintptr_t) heap + HEAP_ALIGN - 1) & ~(uintptr_t) (HEAP_ALIGN - 1);
+
+  return (struct heap_arena_beebs *) start;
+}
+
+static char *
+heap_first (struct heap_arena_beebs *arena)
+{
+  return (char *) arena + HEAP_ARENA_SIZE;
+}
+
+static void
+heap_fail (struct heap_arena_beebs *arena, heap_error_beebs_t err)
+{
+  if (HEAP_OK == arena->error)
+    arena->error = err;
+}
+
+static uint32_t
+heap_guard (const struct heap_block_beebs *block)
+{
+  return HEAP_CANARY ^ block->size ^ (uint32_t) (uintptr_t) block;
+}
+
+static uint32_t *
+heap_tail (struct heap_block_beebs *block)
+{
+  return (uint32_t *) ((char *) (block + 1) + (block->size & ~HEAP_ALLOCATED));
+}
+
+static void
+heap_seal (struct heap_block_beebs *block, uint32_t size)
+{
+  block->size = size;
+  block->guard = heap_guard (block);
+  *heap_tail (block) = HEAP_TAIL_CANARY;
+}
+
+/* Size class of a request, and the payload size of that class. Returns
+   HEAP_CLASSES if the request cannot fit in any class. */
+
+static unsigned int
+heap_class (size_t size, uint32_t *class_size)
+{
+  unsigned int class;
+  size_t cap;
+
+  if (size <= HEAP_SMALL_MAX)
+    {
+      class = (size + HEAP_ALIGN - 1) / HEAP_ALIGN - 1;
+      *class_size = (class + 1) * HEAP_ALIGN;
+      return class;
+    }
+
+  for (class = HEAP_SMALL_CLASSES, cap = HEAP_SMALL_MAX * 2;
+       class < HEAP_CLASSES; class++, cap *= 2)
+    if (size <= cap)
+      {
+	*class_size = cap;
+	return class;
+      }
+
+  return HEAP_CLASSES;
+}
+
+/* Block of an allocated payload, NULL (and an error) if it is not valid */
+
+static struct heap_block_beebs *
+heap_block (struct heap_arena_beebs *arena, void *ptr)
+{
+  struct heap_block_beebs *block = (struct heap_block_beebs *) ptr - 1;
+
+  if (((char *) block < heap_first (arena)) || ((char *) ptr >= arena->ptr)
+      || (0 != ((uintptr_t) ptr % HEAP_ALIGN)))
+    {
+      heap_fail (arena, HEAP_ERR_BAD_POINTER);
+      return NULL;
+    }
+
+  if (block->guard != heap_guard (block))
+    {
+      heap_fail (arena, HEAP_ERR_HEADER);
+      return NULL;
+    }
+
+  if (0 == (block->size & HEAP_ALLOCATED))
+    {
+      heap_fail (arena, HEAP_ERR_DOUBLE_FREE);
+      return NULL;
+    }
+
+  if (HEAP_TAIL_CANARY != *heap_tail (block))
+    {
+      heap_fail (arena, HEAP_ERR_OVERRUN);
+      return NULL;
+    }
+
+  return block;
+}
 
 /* Yield a sequence of random numbers in the range [0, 2^15-1].
 
@@ -55,52 +200,130 @@ srand_beebs (unsigned int new_seed)
 
 
 /* Initialize the BEEBS heap pointers. Note that the actual memory block is
-   in the caller code. */
+   in the caller code. Calling it again resets the heap, dropping every
+   block and any recorded error. The heap also becomes the one used by
+   malloc_beebs and friends. */
 
 void
 init_heap_beebs (void *heap, size_t heap_size)
 {
-  heap_ptr = (void *) heap;
-  heap_end = (void *) ((char *) heap_ptr + heap_size);
-  heap_requested = 0;
+  struct heap_arena_beebs *arena = heap_arena (heap);
+  unsigned int i;
+
+  assert_beebs (heap_first (arena) <= (char *) heap + heap_size);
+
+  arena->ptr = heap_first (arena);
+  arena->end = (char *) heap + heap_size;
+  arena->error = HEAP_OK;
+
+  for (i = 0; i < HEAP_CLASSES; i++)
+    arena->free[i] = NULL;
+
+  heap_current = heap;
 }
 
 
-/* Report if malloc ever failed.
+/* Report if the heap was ever misused.
 
-   Return non-zero (TRUE) if malloc did not reqest more than was available
-   since the last call to init_heap_beebs, zero (FALSE) otherwise. */
+   Walks every block since the last call to init_heap_beebs, checking the
+   headers and tail canaries. Return non-zero (TRUE) if no error was found,
+   zero (FALSE) otherwise, with the class available from heap_error_beebs. */
 
 int
 check_heap_beebs (void *heap)
 {
-  return ((void *) ((char *) heap + heap_requested) <= heap_end);
+  struct heap_arena_beebs *arena = heap_arena (heap);
+  char *p = heap_first (arena);
+
+  while ((HEAP_OK == arena->error) && (p < arena->ptr))
+    {
+      struct heap_block_beebs *block = (struct heap_block_beebs *) p;
+      uint32_t size = block->size & ~HEAP_ALLOCATED;
+
+      if ((block->guard != heap_guard (block))
+	  || (size > (size_t) (arena->ptr - p)))
+	heap_fail (arena, HEAP_ERR_HEADER);
+      else if (HEAP_TAIL_CANARY != *heap_tail (block))
+	heap_fail (arena, HEAP_ERR_OVERRUN);
+
+      p += HEAP_HEADER_SIZE + size + HEAP_TAIL_SIZE;
+    }
+
+  return HEAP_OK == arena->error;
 }
 
 
-/* BEEBS version of malloc.
+/* First error on the heap since the last call to init_heap_beebs */
+
+heap_error_beebs_t
+heap_error_beebs (void *heap)
+{
+  return heap_arena (heap)->error;
+}
 
-   This is primarily to reduce library and OS dependencies. Malloc is
-   generally not used in embedded code, or if it is, only in well defined
-   contexts to pre-allocate a fixed amount of memory. So this simplistic
-   implementation is just fine.
 
-   Note in particular the assumption that memory will never be freed! */
+/* BEEBS version of malloc.
+
+   This is primarily to reduce library and OS dependencies. Blocks are
+   taken from the free list of their size class, or carved from the end of
+   the heap if the list is empty. Returns NULL if the heap is exhausted,
+   which is recorded as HEAP_ERR_EXHAUSTED. */
 
 void *
-malloc_beebs (size_t size)
+malloc_arena_beebs (void *heap, size_t size)
 {
-  void *new_ptr = heap_ptr;
-
-  heap_requested += size;
+  struct heap_arena_beebs *arena = heap_arena (heap);
+  struct heap_block_beebs *block;
+  uint32_t class_size;
+  unsigned int class;
 
-  if (((void *) ((char *) heap_ptr + size) > heap_end) || (0 == size))
+  if (0 == size)
     return NULL;
+
+  class = heap_class (size, &class_size);
+  if (HEAP_CLASSES == class)
+    {
+      heap_fail (arena, HEAP_ERR_EXHAUSTED);
+      return NULL;
+    }
+
+  block = arena->free[class];
+  if (NULL != block)
+    {
+      /* Free blocks keep the next free block in their payload, so a list
+	 head is checked to lie within the carved heap before it is read */
+      if (((char *) block < heap_first (arena)) || ((char *) block >= arena->ptr)
+	  || (0 != ((uintptr_t) block % HEAP_ALIGN))
+	  || ((size_t) (arena->ptr - (char *) block)
+	      < HEAP_HEADER_SIZE + class_size + HEAP_TAIL_SIZE)
+	  || (block->guard != heap_guard (block)) || (block->size != class_size))
+	{
+	  heap_fail (arena, HEAP_ERR_HEADER);
+	  arena->free[class] = NULL;
+	  return NULL;
+	}
+      arena->free[class] = *(struct heap_block_beebs **) (block + 1);
+    }
   else
     {
-      heap_ptr = (void *) ((char *) heap_ptr + size);
-      return new_ptr;
+      if ((size_t) (arena->end - arena->ptr)
+	  < HEAP_HEADER_SIZE + class_size + HEAP_TAIL_SIZE)
+	{
+	  heap_fail (arena, HEAP_ERR_EXHAUSTED);
+	  return NULL;
+	}
+      block = (struct heap_block_beebs *) arena->ptr;
+      arena->ptr += HEAP_HEADER_SIZE + class_size + HEAP_TAIL_SIZE;
     }
+
+  heap_seal (block, class_size | HEAP_ALLOCATED);
+  return block + 1;
+}
+
+void *
+malloc_beebs (size_t size)
+{
+  return malloc_arena_beebs (heap_current, size);
 }
 
 
@@ -109,9 +332,17 @@ malloc_beebs (size_t size)
    Implement as wrapper for malloc */
 
 void *
-calloc_beebs (size_t nmemb, size_t size)
+calloc_arena_beebs (void *heap, size_t nmemb, size_t size)
 {
-  void *new_ptr = malloc_beebs (nmemb * size);
+  void *new_ptr;
+
+  if ((0 != size) && (nmemb > (size_t) -1 / size))
+    {
+      heap_fail (heap_arena (heap), HEAP_ERR_BAD_SIZE);
+      return NULL;
+    }
+
+  new_ptr = malloc_arena_beebs (heap, nmemb * size);
 
   /* Calloc is defined to zero the memory. OK to use a function here, because
      it will be handled specially by the compiler anyway. */
@@ -122,50 +353,93 @@ calloc_beebs (size_t nmemb, size_t size)
   return new_ptr;
 }
 
+void *
+calloc_beebs (size_t nmemb, size_t size)
+{
+  return calloc_arena_beebs (heap_current, nmemb, size);
+}
+
 
 /* BEEBS version of realloc.
 
-   This is primarily to reduce library and OS dependencies. We just have to
-   allocate new memory and copy stuff across. */
+   The header gives the size of the old block, so only that much is copied
+   across. A block that is already big enough is returned unchanged. A size
+   of zero frees the block and returns NULL. */
 
 void *
-realloc_beebs (void *ptr, size_t size)
+realloc_arena_beebs (void *heap, void *ptr, size_t size)
 {
-  void *new_ptr = heap_ptr;
+  struct heap_block_beebs *block;
+  uint32_t old_size;
+  void *new_ptr;
 
-  heap_requested += size;
+  if (NULL == ptr)
+    return malloc_arena_beebs (heap, size);
 
-  if (((void *) ((char *) heap_ptr + size) > heap_end) || (0 == size))
-    return NULL;
-  else
+  if (0 == size)
     {
-      heap_ptr = (void *) ((char *) heap_ptr + size);
-
-      /* This is clunky, since we don't know the size of the original
-         pointer. However it is a read only action and we know it must
-         be big enough if we right off the end, or we couldn't have
-         allocated here. If the size is smaller, it doesn't matter. */
+      free_arena_beebs (heap, ptr);
+      return NULL;
+    }
 
-      if (NULL != ptr)
-	{
-	  size_t i;
+  block = heap_block (heap_arena (heap), ptr);
+  if (NULL == block)
+    return NULL;
 
-	  for (i = 0; i < size; i++)
-	    ((char *) new_ptr)[i] = ((char *) ptr)[i];
-	}
+  old_size = block->size & ~HEAP_ALLOCATED;
+  if (size <= old_size)
+    return ptr;
 
-      return new_ptr;
+  new_ptr = malloc_arena_beebs (heap, size);
+  if (NULL != new_ptr)
+    {
+      memcpy (new_ptr, ptr, old_size);
+      free_arena_beebs (heap, ptr);
     }
+
+  return new_ptr;
+}
+
+void *
+realloc_beebs (void *ptr, size_t size)
+{
+  return realloc_arena_beebs (heap_current, ptr, size);
 }
 
 
 /* BEEBS version of free.
 
-   For our simplified version of memory handling, free can just do nothing. */
+   The block is checked and pushed on the free list of its size class.
+   Invalid pointers, corrupted blocks and double frees are recorded and the
+   block is left alone. */
+
+void
+free_arena_beebs (void *heap, void *ptr)
+{
+  struct heap_arena_beebs *arena = heap_arena (heap);
+  struct heap_block_beebs *block;
+  uint32_t class_size;
+  unsigned int class;
+
+  if (NULL == ptr)
+    return;
+
+  block = heap_block (arena, ptr);
+  if (NULL == block)
+    return;
+
+  class_size = block->size & ~HEAP_ALLOCATED;
+  class = heap_class (class_size, &class_size);
+
+  heap_seal (block, class_size);
+  *(struct heap_block_beebs **) (block + 1) = arena->free[class];
+  arena->free[class] = block;
+}
 
 void
-free_beebs (void *ptr __attribute__ ((unused)))
+free_beebs (void *ptr)
 {
+  free_arena_beebs (heap_current, ptr);
 }
 
 
@@ -29,8 +29,8 @@
 #include <nettle-aes/nettle-aes.h>
 #include <nettle-sha256/nettle-sha256.h>
 #include <nsichneu/libnsichneu.h>
-//#include <picojpeg/picojpeg_test.h>
-//#include <qrduino/qrtest.h>
+#include <picojpeg/picojpeg_test.h>
+#include <qrduino/qrtest.h>
 #include <sglib-combined/combined.h>
 #include <slre/libslre.h>
 #include <st/libst.h>
@@ -40,6 +40,39 @@
 
 #define WARMUP_HEAT 1
 
+/* Kernel variants for workloads that provide vectorised alternatives. The
+   variant is selected per workload at compile time, for instance with
+   -DEDN_KERNEL=KERNEL_SIMD. All variants share the workload verification. */
+
+#define KERNEL_SCALAR   0  /* Original reference code                         */
+#define KERNEL_AUTOVEC  1  /* Loops restructured for the compiler vectoriser  */
+#define KERNEL_SIMD     2  /* Hand-written SIMD where the target provides it  */
+
+/* Input mode. With -DRANDOM_INPUTS=1 the workloads that support it draw new
+   inputs from their own xorshift32_beebs stream, and check the result with
+   an invariant or an inverse operation instead of stored results.
+
+   RANDOM_INPUTS_PERIOD executions share one draw, which keeps the cost of
+   drawing and of the invariant off the throughput. Where the invariant
+   costs more than the stored result comparison, the first execution checked
+   after a draw is checked by the invariant and its result is kept, and the
+   others are checked against that result as fixed inputs are against stored
+   ones. A failing execution makes the next one draw again.
+
+   Such a workload keeps three words: <workload>_rng, the stream state,
+   <workload>_seed, a copy of the state taken when a draw starts, and
+   <workload>_left, the executions left on the current draw. A failing
+   execution logs the copy as seed=: setting the stream to that value draws
+   the same inputs again. The stream starts from a fixed value when the
+   workload is first initialised and then carries on across cycles, each of
+   which starts with a new draw, so no two draws of a run are the same. */
+#ifndef RANDOM_INPUTS
+#define RANDOM_INPUTS 0
+#endif
+#ifndef RANDOM_INPUTS_PERIOD
+#define RANDOM_INPUTS_PERIOD 64
+#endif
+
 /* Standard functions implemented for each board */
 
 void initialise_board(void);
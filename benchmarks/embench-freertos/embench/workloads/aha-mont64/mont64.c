@@ -38,32 +38,41 @@ some 128-bit arithmetic.
 #include <stdio.h>
 unsigned int mont64_errors;
 unsigned int mont64_executions; 
+unsigned int mont64_batch_errors;
+unsigned int mont64_batch_executions;
 
 typedef uint64_t uint64;
 typedef int64_t int64;
 
-/* ---------------------------- mulul64 ----------------------------- */
+/* 64 x 64 ==> 128 multiplier used by mulul64 (), and so by montmul ().  The
+   results of the selected one are checked against mulul64_ref () in every
+   execution. */
 
-/* Multiply unsigned long 64-bit routine, i.e., 64 * 64 ==> 128.
-Parameters u and v are multiplied and the 128-bit product is placed in
-(*whi, *wlo). If __int128 is not defined by the compiler, we fall back
-to Knuth's Algorithm M from [Knu2] section 4.3.1. Derived from muldwu.c
-in the Hacker's Delight collection. */
+#define MONT64_MUL_PORTABLE 0	/* 32-bit halves, Knuth's Algorithm M     */
+#define MONT64_MUL_INT128   1	/* unsigned __int128                      */
+#define MONT64_MUL_MULHU    2	/* RISC-V mul and mulhu, else __int128    */
 
+#ifndef MONT64_MUL
 #ifdef __SIZEOF_INT128__
-void
-mulul64 (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
-{
-  unsigned __int128 result;
+#define MONT64_MUL MONT64_MUL_INT128
+#else
+#define MONT64_MUL MONT64_MUL_PORTABLE
+#endif
+#endif
 
-  result = (unsigned __int128)u * v;
+#if (MONT64_MUL != MONT64_MUL_PORTABLE) && !defined (__SIZEOF_INT128__)
+#error "MONT64_MUL needs a 64-bit target with __int128"
+#endif
+
+/* ---------------------------- mulul64 ----------------------------- */
+
+/* Multiply unsigned long 64-bit routine, i.e., 64 * 64 ==> 128.
+Parameters u and v are multiplied and the 128-bit product is placed in
+(*whi, *wlo). The reference version is Knuth's Algorithm M from [Knu2]
+section 4.3.1. Derived from muldwu.c in the Hacker's Delight collection. */
 
-  *wlo = result;
-  *whi = result >> 64;
-}
-#else
 void
-mulul64 (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
+mulul64_ref (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
 {
   uint64 u0, u1, v0, v1, k, t;
   uint64 w0, w1, w2;
@@ -89,6 +98,35 @@ mulul64 (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
 
   return;
 }
+
+#if (MONT64_MUL == MONT64_MUL_MULHU) && defined (__riscv) && (__riscv_xlen == 64)
+void
+mulul64 (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
+{
+  uint64 hi;
+
+  __asm__ ("mulhu %0, %1, %2" : "=r" (hi) : "r" (u), "r" (v));
+
+  *wlo = u * v;
+  *whi = hi;
+}
+#elif (MONT64_MUL != MONT64_MUL_PORTABLE)
+void
+mulul64 (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
+{
+  unsigned __int128 result;
+
+  result = (unsigned __int128)u * v;
+
+  *wlo = result;
+  *whi = result >> 64;
+}
+#else
+void
+mulul64 (uint64 u, uint64 v, uint64 * whi, uint64 * wlo)
+{
+  mulul64_ref (u, v, whi, wlo);
+}
 #endif
 
 /* ---------------------------- modul64 ----------------------------- */
@@ -223,6 +261,34 @@ xbinGCD (uint64 a, uint64 b, volatile uint64 * pu, volatile uint64 * pv)
 /* ------------------------------ main ------------------------------ */
 static uint64 in_a, in_b, in_m;
 
+#if (RANDOM_INPUTS == 1)
+/* Two words per operand, m then b then a */
+static uint32_t mont64_rng;
+static uint32_t mont64_seed;
+static unsigned int mont64_left;
+
+static uint64
+mont64_random_word (void)
+{
+  uint64 hi = xorshift32_beebs (&mont64_rng);
+
+  return (hi << 32) | xorshift32_beebs (&mont64_rng);
+}
+
+/* New operands for every draw. The Montgomery result is checked against
+   the modul64 () path in every execution, as for the fixed ones, which only
+   needs m odd and a, b < m: m gets its top bit set and a, b have it clear,
+   so no division is needed. */
+static void
+mont64_random_inputs (void)
+{
+  mont64_seed = mont64_rng;
+  in_m = mont64_random_word () | 0x8000000000000001ULL;
+  in_b = mont64_random_word () & 0x7fffffffffffffffULL;
+  in_a = mont64_random_word () & 0x7fffffffffffffffULL;
+}
+#endif
+
 static int mont64_benchmark_body (int  rpt);
 
 void
@@ -243,7 +309,12 @@ mont64_benchmark (void)
     if(mont64_verify_benchmark(mont64_benchmark_body(1)) != 1)
     {
       mont64_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] aha-mont64: errnum=%u itr=%u\n", mont64_errors, mont64_executions);
+#if (RANDOM_INPUTS == 1)
+      mont64_left = 0;
+      log_error_event("aha-mont64", mont64_errors, mont64_executions, " seed=0x%08x", mont64_seed, 0);
+#else
+      log_error_event("aha-mont64", mont64_errors, mont64_executions, NULL, 0, 0);
+#endif
     }
   }
 }
@@ -262,18 +333,26 @@ mont64_benchmark_body (int rpt)
       volatile uint64 rinv, mprime;
       errors = 0;
 
+#if (RANDOM_INPUTS == 1)
+      if (0 == mont64_left)
+	{
+	  mont64_random_inputs ();
+	  mont64_left = RANDOM_INPUTS_PERIOD;
+	}
+      mont64_left--;
+#endif
       m = in_m;			// Must be odd.
       b = in_b;			// Must be smaller than m.
       a = in_a;			// Must be smaller than m.
 
       /* The simple calculation: This computes (a*b)**4 (mod m) correctly for all a,
-         b, m < 2**64. */
+         b, m < 2**64. It always uses the reference multiplier. */
 
-      mulul64 (a, b, &p1hi, &p1lo);	// Compute a*b (mod m).
+      mulul64_ref (a, b, &p1hi, &p1lo);	// Compute a*b (mod m).
       p1 = modul64 (p1hi, p1lo, m);
-      mulul64 (p1, p1, &p1hi, &p1lo);	// Compute (a*b)**2 (mod m).
+      mulul64_ref (p1, p1, &p1hi, &p1lo);	// Compute (a*b)**2 (mod m).
       p1 = modul64 (p1hi, p1lo, m);
-      mulul64 (p1, p1, &p1hi, &p1lo);	// Compute (a*b)**4 (mod m).
+      mulul64_ref (p1, p1, &p1hi, &p1lo);	// Compute (a*b)**4 (mod m).
       p1 = modul64 (p1hi, p1lo, m);
 
       /* The MM method uses a quantity r that is the smallest power of 2
@@ -340,6 +419,11 @@ mont64_initialise_benchmark (void)
   in_m = 0xfae849273928f89fLL;	// Must be odd.
   in_b = 0x14736defb9330573LL;	// Must be smaller than m.
   in_a = 0x0549372187237fefLL;	// Must be smaller than m.
+#if (RANDOM_INPUTS == 1)
+  if (0 == mont64_rng)
+    mont64_rng = 0x6d6f6e74U;
+  mont64_left = 0;
+#endif
 
   mont64_errors = 0;
   mont64_executions = 0;
@@ -366,6 +450,177 @@ mont64_get_executions (void)
 }
 
 
+// Batched modular exponentiation
+
+/* MONT64_BATCH_LANES independent a**e (mod m), each with its own modulus,
+   advanced together one exponent bit at a time so that the montmul ()
+   chains of the lanes can overlap in the pipeline. */
+
+#ifndef MONT64_BATCH_LANES
+#define MONT64_BATCH_LANES 8
+#endif
+
+#ifdef IS_SIMULATION
+#define BATCH_SCALE_FACTOR    1
+#else
+#define BATCH_SCALE_FACTOR    86
+#define BATCH_EXECUTIONS      (BATCH_SCALE_FACTOR * CPU_MHZ)
+#endif
+
+struct mont64_lane
+{
+  uint64 m, mprime;		/* Modulus and -1/m (mod 2**64)          */
+  uint64 abar, one;		/* a and 1 in Montgomery form             */
+  uint64 e;			/* Exponent                               */
+  uint64 expected;		/* a**e (mod m) by the reference path     */
+};
+
+static struct mont64_lane batch_lanes[MONT64_BATCH_LANES];
+
+/* First lane that failed in the last execution */
+static int batch_first_bad;
+
+static uint64
+batch_next (uint64 * state)
+{
+  uint64 z = (*state += 0x9e3779b97f4a7c15ULL);
+
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+  return z ^ (z >> 31);
+}
+
+void
+mont64_batch_initialise_benchmark (void)
+{
+  uint64 state = 0x0549372187237fefLL;
+  int l;
+
+  for (l = 0; l < MONT64_BATCH_LANES; l++)
+    {
+      struct mont64_lane *lane = &batch_lanes[l];
+      volatile uint64 rinv, mprime;
+      uint64 a, e, p, phi, plo;
+
+      lane->m = batch_next (&state) | 0x8000000000000001ULL;
+      a = batch_next (&state) % lane->m;
+      lane->e = batch_next (&state) | 0x8000000000000000ULL;
+
+      xbinGCD (0x8000000000000000LL, lane->m, &rinv, &mprime);
+      lane->mprime = mprime;
+      lane->abar = modul64 (a, 0, lane->m);
+      lane->one = modul64 (1, 0, lane->m);
+
+      /* Square and multiply with the reference multiplier and modul64 () */
+      p = 1;
+      for (e = lane->e; e != 0; e >>= 1)
+	{
+	  if (e & 1)
+	    {
+	      mulul64_ref (p, a, &phi, &plo);
+	      p = modul64 (phi, plo, lane->m);
+	    }
+	  mulul64_ref (a, a, &phi, &plo);
+	  a = modul64 (phi, plo, lane->m);
+	}
+      lane->expected = p;
+    }
+
+  mont64_batch_errors = 0;
+  mont64_batch_executions = 0;
+}
+
+
+static int mont64_batch_benchmark_body (int  rpt);
+
+void
+mont64_batch_warm_caches (int  heat)
+{
+  int  res = mont64_batch_benchmark_body (heat);
+
+  return;
+}
+
+
+void
+mont64_batch_benchmark (void)
+{
+  for (unsigned int i = 0; i < BATCH_EXECUTIONS; i++)
+  {
+    mont64_batch_executions++;
+    /* Execute once and check if different of correct */
+    if(mont64_batch_verify_benchmark(mont64_batch_benchmark_body(1)) != 1)
+    {
+      mont64_batch_errors++;
+      log_error_event("aha-mont64-batch", mont64_batch_errors, mont64_batch_executions, " lane=%d", batch_first_bad, 0);
+    }
+  }
+}
+
+
+/* Returns the number of lanes that differ from the reference path */
+
+static int __attribute__ ((noinline))
+mont64_batch_benchmark_body (int rpt)
+{
+  uint64 x[MONT64_BATCH_LANES];
+  int errors = 0;
+  int i, l, bit;
+
+  for (i = 0; i < rpt; i++)
+    {
+      errors = 0;
+      batch_first_bad = -1;
+
+      for (l = 0; l < MONT64_BATCH_LANES; l++)
+	x[l] = batch_lanes[l].one;
+
+      /* Left to right, the multiply is always done and then selected so
+	 every lane follows the same path */
+      for (bit = 63; bit >= 0; bit--)
+	for (l = 0; l < MONT64_BATCH_LANES; l++)
+	  {
+	    const struct mont64_lane *lane = &batch_lanes[l];
+	    uint64 sq = montmul (x[l], x[l], lane->m, lane->mprime);
+	    uint64 mu = montmul (sq, lane->abar, lane->m, lane->mprime);
+	    uint64 take = -((lane->e >> bit) & 1);
+
+	    x[l] = (mu & take) | (sq & ~take);
+	  }
+
+      /* Out of Montgomery form, x * 1 / r (mod m) */
+      for (l = 0; l < MONT64_BATCH_LANES; l++)
+	if (montmul (x[l], 1, batch_lanes[l].m, batch_lanes[l].mprime)
+	    != batch_lanes[l].expected)
+	  {
+	    if (0 == errors++)
+	      batch_first_bad = l;
+	  }
+    }
+
+  return errors;
+}
+
+int
+mont64_batch_verify_benchmark (int r)
+{
+  return 0 == r;
+}
+
+unsigned int
+mont64_batch_get_errors (void)
+{
+  return mont64_batch_errors;
+}
+
+unsigned int
+mont64_batch_get_executions (void)
+{
+  return mont64_batch_executions;
+}
+
+
 /*
    Local Variables:
    mode: C
@@ -40,6 +40,14 @@ int mont64_verify_benchmark(int res);
 unsigned int mont64_get_errors(void);
 unsigned int mont64_get_executions(void);
 
+/* Batched modular exponentiation variant (aha-mont64-batch workload) */
+void mont64_batch_initialise_benchmark(void);
+void mont64_batch_warm_caches(int temperature);
+void mont64_batch_benchmark(void) __attribute__ ((noinline));
+int mont64_batch_verify_benchmark(int res);
+unsigned int mont64_batch_get_errors(void);
+unsigned int mont64_batch_get_executions(void);
+
 
 /* Local simplified versions of library functions */
 
@@ -25,14 +25,28 @@
 #define LOCAL_SCALE_FACTOR    2
 #else
 #define LOCAL_SCALE_FACTOR    31
+#if (RANDOM_INPUTS == 1)
+/* Three CRCs per execution, the same number of bytes per run */
+#define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ / 3)
+#else
 #define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
 #endif
+#endif
 
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
 
 #include <stdio.h>
 unsigned int crc32_errors;
 unsigned int crc32_executions; 
+unsigned int crc32_slice8_errors;
+unsigned int crc32_slice8_executions;
+unsigned int crc32_clmul_errors;
+unsigned int crc32_clmul_executions;
 
 #ifdef __TURBOC__
 #pragma warn -cln
@@ -61,6 +75,32 @@ typedef unsigned short WORD;
 
 typedef DWORD UNS_32_BITS;
 
+/* Input bytes. The fixed inputs are the rand_beebs () sequence from seed 0.
+   With RANDOM_INPUTS each execution computes the CRC of random buffers A, B
+   and A ^ B, drawn every RANDOM_INPUTS_PERIOD executions, and checks the
+   linearity of the CRC:
+   crc (A) ^ crc (B) ^ crc (A ^ B) == crc (0). */
+
+#define CRC32_LEN 1024
+
+#if (RANDOM_INPUTS == 1)
+static BYTE crc32_buf[3][CRC32_LEN] __attribute__ ((aligned (4)));
+static const BYTE *crc32_input;
+static int crc32_input_pos;
+
+/* Shared by the three CRC workloads, one word per 4 bytes of A and of B */
+static uint32_t crc32_rng;
+static uint32_t crc32_seed;
+static unsigned int crc32_left;
+
+/* CRC of CRC32_LEN zero bytes */
+static uint32_t crc32_zero;
+
+#define CRC32_INPUT_BYTE() (crc32_input[crc32_input_pos++])
+#else
+#define CRC32_INPUT_BYTE() ((BYTE) rand_beebs ())
+#endif
+
 /* Copyright (C) 1986 Gary S. Brown.  You may use this program, or
    code or tables extracted from it, as desired without restriction.*/
 
@@ -165,68 +205,326 @@ crc32pseudo (void)
 
   oldcrc32 = 0xFFFFFFFF;
 
-  for (i = 0; i < 1024; ++i)
+  for (i = 0; i < CRC32_LEN; ++i)
     {
-      oldcrc32 = UPDC32 (rand_beebs (), oldcrc32);
+      oldcrc32 = UPDC32 (CRC32_INPUT_BYTE (), oldcrc32);
     }
 
   return ~oldcrc32;
 }
 
+
+/* Alternative implementations over the same pseudo-random bytes, checked
+   against the same result. They stress different resources: slice-by-8
+   keeps 8 KB of tables busy in the cache, while the carry-less multiply
+   version has no table at all and runs on the multiplier datapath. */
+
+/* Slice-by-8: table k gives the CRC of a byte followed by k zero bytes, so
+   eight bytes are folded per step. Tables are rebuilt from crc_32_tab at
+   every initialisation, which bounds the life of a corrupted entry to one
+   cycle. */
+
+static uint32_t crc_32_slice8_tab[8][256];
+
+static void
+crc32_slice8_init_tables (void)
+{
+  int i, k;
+
+  for (i = 0; i < 256; i++)
+    crc_32_slice8_tab[0][i] = (uint32_t) crc_32_tab[i];
+
+  for (k = 1; k < 8; k++)
+    for (i = 0; i < 256; i++)
+      {
+	uint32_t prev = crc_32_slice8_tab[k - 1][i];
+	crc_32_slice8_tab[k][i] = (prev >> 8) ^ crc_32_slice8_tab[0][prev & 0xff];
+      }
+}
+
+DWORD
+crc32pseudo_slice8 (void)
+{
+  int i, k;
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t lo, hi;
+
+  for (i = 0; i < CRC32_LEN; i += 8)
+    {
+      lo = 0;
+      hi = 0;
+      for (k = 0; k < 32; k += 8)
+	lo |= (uint32_t) CRC32_INPUT_BYTE () << k;
+      for (k = 0; k < 32; k += 8)
+	hi |= (uint32_t) CRC32_INPUT_BYTE () << k;
+
+      crc ^= lo;
+      crc = crc_32_slice8_tab[7][crc & 0xff]
+	^ crc_32_slice8_tab[6][(crc >> 8) & 0xff]
+	^ crc_32_slice8_tab[5][(crc >> 16) & 0xff]
+	^ crc_32_slice8_tab[4][crc >> 24]
+	^ crc_32_slice8_tab[3][hi & 0xff]
+	^ crc_32_slice8_tab[2][(hi >> 8) & 0xff]
+	^ crc_32_slice8_tab[1][(hi >> 16) & 0xff]
+	^ crc_32_slice8_tab[0][hi >> 24];
+    }
+
+  return ~crc;
+}
+
+/* Carry-less multiply of two 32-bit polynomials. Without a clmul instruction
+   the integer multiplier does it: operands are split into every fourth bit,
+   so carries (at most 8 per column here) land in the gaps that are masked
+   off afterwards. */
+
+static inline uint64_t
+clmul32 (uint32_t a, uint32_t b)
+{
+#if defined(__PCLMUL__)
+  return (uint64_t) _mm_cvtsi128_si64 (_mm_clmulepi64_si128
+				       (_mm_cvtsi32_si128 ((int) a),
+					_mm_cvtsi32_si128 ((int) b), 0));
+#elif defined(__riscv_zbc) && (__riscv_xlen == 64)
+  uint64_t r;
+
+  __asm__ ("clmul %0, %1, %2" : "=r" (r) : "r" ((uint64_t) a), "r" ((uint64_t) b));
+  return r;
+#else
+  const uint64_t m0 = 0x1111111111111111ULL;
+  const uint64_t m1 = 0x2222222222222222ULL;
+  const uint64_t m2 = 0x4444444444444444ULL;
+  const uint64_t m3 = 0x8888888888888888ULL;
+  uint64_t x0 = a & m0, x1 = a & m1, x2 = a & m2, x3 = a & m3;
+  uint64_t y0 = b & m0, y1 = b & m1, y2 = b & m2, y3 = b & m3;
+  uint64_t z0, z1, z2, z3;
+
+  z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+  z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+  z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+  z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+
+  return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+#endif
+}
+
+/* Bit-reflected polynomial P and Barrett constant mu = x^64 / P, both with
+   the x^32 term implied. */
+#define CRC32_POLY_LO  0xDB710641U
+#define CRC32_MU_LO    0xF7011641U
+
+/* Returns v * x^32 mod P, i.e. the CRC register after 32 bits of input. */
+static inline uint32_t
+crc32_fold32 (uint32_t v)
+{
+  uint32_t t = (uint32_t) clmul32 (v, CRC32_MU_LO);
+
+  return (uint32_t) (clmul32 (t, CRC32_POLY_LO) >> 32) ^ t;
+}
+
+DWORD
+crc32pseudo_clmul (void)
+{
+  int i, k;
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t w;
+
+  for (i = 0; i < CRC32_LEN; i += 4)
+    {
+      w = 0;
+      for (k = 0; k < 32; k += 8)
+	w |= (uint32_t) CRC32_INPUT_BYTE () << k;
+
+      crc = crc32_fold32 (crc ^ w);
+    }
+
+  return ~crc;
+}
+
+#if (RANDOM_INPUTS == 1)
+static void
+crc32_random_initialise (void)
+{
+  memset (crc32_buf[0], 0, CRC32_LEN);
+  crc32_input = crc32_buf[0];
+  crc32_input_pos = 0;
+  crc32_zero = (uint32_t) crc32pseudo ();
+  crc32_left = 0;		/* A was just cleared */
+  if (0 == crc32_rng)
+    crc32_rng = 0x63726333U;
+}
+
+/* New buffers A, B and A ^ B */
+static void
+crc32_random_inputs (void)
+{
+  int i;
+
+  crc32_seed = crc32_rng;
+  for (i = 0; i < CRC32_LEN; i += 4)
+    {
+      uint32_t a = xorshift32_beebs (&crc32_rng);
+      uint32_t b = xorshift32_beebs (&crc32_rng);
+      uint32_t c = a ^ b;
+
+      /* Word stores, the byte order does not matter to the check */
+      memcpy (&crc32_buf[0][i], &a, 4);
+      memcpy (&crc32_buf[1][i], &b, 4);
+      memcpy (&crc32_buf[2][i], &c, 4);
+    }
+}
+#endif
+
 void
 crc32_initialise_benchmark (void)
 {
+#if (RANDOM_INPUTS == 1)
+  crc32_random_initialise ();
+#endif
   crc32_errors = 0;
   crc32_executions = 0;
 }
 
+void
+crc32_slice8_initialise_benchmark (void)
+{
+  crc32_slice8_init_tables ();
+#if (RANDOM_INPUTS == 1)
+  crc32_random_initialise ();
+#endif
+  crc32_slice8_errors = 0;
+  crc32_slice8_executions = 0;
+}
 
-static int crc32_benchmark_body (int  rpt);
+void
+crc32_clmul_initialise_benchmark (void)
+{
+#if (RANDOM_INPUTS == 1)
+  crc32_random_initialise ();
+#endif
+  crc32_clmul_errors = 0;
+  crc32_clmul_executions = 0;
+}
+
+
+static int crc32_benchmark_body (DWORD (*crc32_impl) (void), int  rpt);
+static void crc32_benchmark_run (DWORD (*crc32_impl) (void), const char *name,
+				 unsigned int *errors, unsigned int *executions);
 
 void
 crc32_warm_caches (int  heat)
 {
-  int  res = crc32_benchmark_body (heat);
+  int  res = crc32_benchmark_body (&crc32pseudo, heat);
+
+  return;
+}
+
+void
+crc32_slice8_warm_caches (int  heat)
+{
+  int  res = crc32_benchmark_body (&crc32pseudo_slice8, heat);
+
+  return;
+}
+
+void
+crc32_clmul_warm_caches (int  heat)
+{
+  int  res = crc32_benchmark_body (&crc32pseudo_clmul, heat);
 
   return;
 }
 
 void
 crc32_benchmark (void)
+{
+  crc32_benchmark_run (&crc32pseudo, "crc32", &crc32_errors, &crc32_executions);
+}
+
+void
+crc32_slice8_benchmark (void)
+{
+  crc32_benchmark_run (&crc32pseudo_slice8, "crc32-slice8",
+		       &crc32_slice8_errors, &crc32_slice8_executions);
+}
+
+void
+crc32_clmul_benchmark (void)
+{
+  crc32_benchmark_run (&crc32pseudo_clmul, "crc32-clmul",
+		       &crc32_clmul_errors, &crc32_clmul_executions);
+}
+
+
+static void
+crc32_benchmark_run (DWORD (*crc32_impl) (void), const char *name,
+		     unsigned int *errors, unsigned int *executions)
 {
   for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
   {
-    crc32_executions++;
+    (*executions)++;
     /* Execute once and check if different of correct */
-    if(crc32_verify_benchmark(crc32_benchmark_body(1)) != 1)
+    if(crc32_verify_benchmark(crc32_benchmark_body(crc32_impl, 1)) != 1)
     {
-      crc32_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] crc32: errnum=%u itr=%u\n", crc32_errors, crc32_executions);
+      (*errors)++;
+#if (RANDOM_INPUTS == 1)
+      crc32_left = 0;
+      log_error_event(name, *errors, *executions, " seed=0x%08x", crc32_seed, 0);
+#else
+      log_error_event(name, *errors, *executions, NULL, 0, 0);
+#endif
     }
   }
 }
 
 
 static int __attribute__ ((noinline))
-crc32_benchmark_body (int rpt)
+crc32_benchmark_body (DWORD (*crc32_impl) (void), int rpt)
 {
   int i;
   DWORD r;
 
+#if (RANDOM_INPUTS == 1)
+  for (i = 0; i < rpt; i++)
+    {
+      int k;
+
+      if (0 == crc32_left)
+	{
+	  crc32_random_inputs ();
+	  crc32_left = RANDOM_INPUTS_PERIOD;
+	}
+      crc32_left--;
+      r = crc32_zero;
+      for (k = 0; k < 3; k++)
+	{
+	  crc32_input = crc32_buf[k];
+	  crc32_input_pos = 0;
+	  r ^= crc32_impl ();
+	}
+    }
+
+  /* Nonzero if linearity does not hold */
+  return (uint32_t) r != 0;
+#else
   for (i = 0; i < rpt; i++)
     {
       srand_beebs (0);
-      r = crc32pseudo ();
+      r = crc32_impl ();
     }
 
   return (int) (r % 32768);
+#endif
 }
 
 
 int
 crc32_verify_benchmark (int r)
 {
+#if (RANDOM_INPUTS == 1)
+  return 0 == r;
+#else
   return 11433 == r;
+#endif
 }
 
 unsigned int
@@ -241,6 +539,30 @@ crc32_get_executions (void)
   return crc32_executions;
 }
 
+unsigned int
+crc32_slice8_get_errors (void)
+{
+  return crc32_slice8_errors;
+}
+
+unsigned int
+crc32_slice8_get_executions (void)
+{
+  return crc32_slice8_executions;
+}
+
+unsigned int
+crc32_clmul_get_errors (void)
+{
+  return crc32_clmul_errors;
+}
+
+unsigned int
+crc32_clmul_get_executions (void)
+{
+  return crc32_clmul_executions;
+}
+
 
 /* vim: set ts=3 sw=3 et: */
 
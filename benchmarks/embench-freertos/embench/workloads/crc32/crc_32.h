@@ -40,6 +40,21 @@ int crc32_verify_benchmark(int res);
 unsigned int crc32_get_errors(void);
 unsigned int crc32_get_executions(void);
 
+/* Alternative implementations, run as separate workloads so that their
+   throughput and errors are reported side by side. Verification is shared
+   with crc32. */
+void crc32_slice8_initialise_benchmark(void);
+void crc32_slice8_warm_caches(int temperature);
+void crc32_slice8_benchmark(void) __attribute__ ((noinline));
+unsigned int crc32_slice8_get_errors(void);
+unsigned int crc32_slice8_get_executions(void);
+
+void crc32_clmul_initialise_benchmark(void);
+void crc32_clmul_warm_caches(int temperature);
+void crc32_clmul_benchmark(void) __attribute__ ((noinline));
+unsigned int crc32_clmul_get_errors(void);
+unsigned int crc32_clmul_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* CRC_32_H */
@@ -41,6 +41,14 @@ int cubic_verify_benchmark(int res);
 unsigned int cubic_get_errors(void);
 unsigned int cubic_get_executions(void);
 
+/* Batch solver variant (cubic-batch workload) */
+void cubic_batch_initialise_benchmark(void);
+void cubic_batch_warm_caches(int temperature);
+void cubic_batch_benchmark(void) __attribute__ ((noinline));
+int cubic_batch_verify_benchmark(int res);
+unsigned int cubic_batch_get_errors(void);
+unsigned int cubic_batch_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* CUBIC_H */
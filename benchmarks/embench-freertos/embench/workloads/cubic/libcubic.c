@@ -55,6 +55,61 @@ SolveCubic (double a, double b, double c, double d, int *solutions, double *x)
     }
 }
 
+/* Batch solver for the cubic-batch workload.  Finds the real roots of n
+   cubics a x^3 + b x^2 + c x + d, a != 0, without libm calls or data
+   dependent branches, so the loop can be vectorised.
+
+   The sign of the monic cubic at its inflection point tells which side of
+   it holds a real root with no turning point beyond it: the smallest root
+   when the sign is positive, the largest otherwise.  Newton's method
+   started at the Cauchy bound on that side converges monotonically to that
+   root, which is then divided out and the remaining quadratic solved
+   directly.  x0 receives the Newton root; x1 and x2 receive the other two
+   when they are real and repeat x0 otherwise. */
+
+void
+SolveCubicBatch (const double *a, const double *b, const double *c,
+		 const double *d, int n, int *solutions, double *x0,
+		 double *x1, double *x2)
+{
+  int i, k;
+
+  for (i = 0; i < n; i++)
+    {
+      double a1 = b[i] / a[i];
+      double a2 = c[i] / a[i];
+      double a3 = d[i] / a[i];
+      double bound = 1.0 + fmax (fabs (a1), fmax (fabs (a2), fabs (a3)));
+      double xi = -a1 / 3.0;
+      double x = (((xi + a1) * xi + a2) * xi + a3 > 0.0) ? -bound : bound;
+      double e, f, disc, q, y1, y2;
+      int real;
+
+      for (k = 0; k < CUBIC_NEWTON_STEPS; k++)
+	{
+	  double p = ((x + a1) * x + a2) * x + a3;
+	  double dp = (3.0 * x + 2.0 * a1) * x + a2;
+
+	  /* dp only vanishes once x sits on a multiple root */
+	  x -= (dp != 0.0) ? p / dp : 0.0;
+	}
+
+      /* Deflate to x^2 + e x + f and solve without cancellation */
+      e = a1 + x;
+      f = a2 + e * x;
+      disc = e * e - 4.0 * f;
+      real = disc >= 0.0;
+      q = -0.5 * (e + copysign (sqrt (fmax (disc, 0.0)), e));
+      y1 = q;
+      y2 = (q != 0.0) ? f / q : q;
+
+      solutions[i] = real ? 3 : 1;
+      x0[i] = x;
+      x1[i] = real ? y1 : x;
+      x2[i] = real ? y2 : x;
+    }
+}
+
 /* vim: set ts=3 sw=3 et: */
 
 
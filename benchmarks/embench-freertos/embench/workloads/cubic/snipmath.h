@@ -33,6 +33,15 @@
 
 void SolveCubic (double a, double b, double c,	/* Cubic.C        */
 		 double d, int *solutions, double *x);
+void SolveCubicBatch (const double *a, const double *b,	/* Cubic.C */
+		      const double *c, const double *d, int n,
+		      int *solutions, double *x0, double *x1, double *x2);
+
+/* Newton steps per cubic in SolveCubicBatch, enough for the triple root
+   of a cubic whose coefficients are bounded by 2^5 */
+#ifndef CUBIC_NEWTON_STEPS
+#define CUBIC_NEWTON_STEPS 40
+#endif
 
 
 /*
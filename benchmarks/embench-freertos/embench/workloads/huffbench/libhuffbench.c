@@ -67,7 +67,7 @@ unsigned int huffbench_executions;
 /* BEEBS heap is just an array */
 
 #define HEAP_SIZE 8192
-static char heap[HEAP_SIZE];
+static char beebs_heap[HEAP_SIZE];
 
 #define TEST_SIZE 500
 
@@ -130,6 +130,36 @@ static const byte orig_data[TEST_SIZE] = {
 
 static byte test_data[TEST_SIZE];
 
+#if (RANDOM_INPUTS == 1)
+/* One word for the symbol count, then one per four bytes of text */
+static uint32_t huffbench_rng;
+static uint32_t huffbench_seed;
+static unsigned int huffbench_left;
+
+/* Input of the current draw, compared with the round trip result */
+static byte random_data[TEST_SIZE];
+
+/* New text for every draw, nearly uniform over 24 to 40 symbols from '0'
+   upwards. The fixed text has 32 nearly uniform symbols, so the work per
+   execution stays close while the code tree changes with every draw. */
+static void
+huffbench_random_inputs (void)
+{
+  uint32_t w;
+  unsigned int symbols;
+  size_t i, k;
+
+  huffbench_seed = huffbench_rng;
+  symbols = 24 + xorshift32_beebs (&huffbench_rng) % 17;
+  for (i = 0; i < TEST_SIZE; i += 4)
+    {
+      w = xorshift32_beebs (&huffbench_rng);
+      for (k = 0; k < 4 && i + k < TEST_SIZE; k++, w >>= 8)
+	random_data[i + k] = (byte) ('0' + (((w & 0xff) * symbols) >> 8));
+    }
+}
+#endif
+
 
 // utility function for processing compression trie
 static void
@@ -177,7 +207,11 @@ compdecomp (byte * data, size_t data_len)
    */
 
   // allocate data space
-  byte *comp = (byte *) malloc_beebs (data_len + 1);
+  byte *comp = (byte *) malloc_arena_beebs ((void *) beebs_heap, data_len + 1);
+
+  // the heap records the failure, leave the data untouched
+  if (NULL == comp)
+    return;
 
   size_t freq[512];		// allocate frequency table
   size_t heap[256];		// allocate heap
@@ -294,7 +328,7 @@ compdecomp (byte * data, size_t data_len)
 
   // encode data
   size_t comp_len = 0;		// number of data_len output
-  char bout = 0;		// byte of encoded data
+  byte bout = 0;		// byte of encoded data
   int bit = -1;			// count of bits stored in bout
   dptr = data;
 
@@ -456,20 +490,32 @@ compdecomp (byte * data, size_t data_len)
     }
 
   // remove work areas
-  free_beebs (comp);
+  free_arena_beebs ((void *) beebs_heap, comp);
 }
 
 
 int
 huffbench_verify_benchmark (int res __attribute ((unused)))
 {
-  return 0 == memcmp (test_data, orig_data, TEST_SIZE * sizeof (orig_data[0]));
+#if (RANDOM_INPUTS == 1)
+  /* decompress (compress (x)) == x */
+  return (0 == memcmp (test_data, random_data, TEST_SIZE * sizeof (random_data[0])))
+    && check_heap_beebs ((void *) beebs_heap);
+#else
+  return (0 == memcmp (test_data, orig_data, TEST_SIZE * sizeof (orig_data[0])))
+    && check_heap_beebs ((void *) beebs_heap);
+#endif
 }
 
 
 void
 huffbench_initialise_benchmark (void)
 {
+#if (RANDOM_INPUTS == 1)
+  if (0 == huffbench_rng)
+    huffbench_rng = 0x68756666U;
+  huffbench_left = 0;
+#endif
   huffbench_errors = 0;
   huffbench_executions = 0;
 }
@@ -496,7 +542,12 @@ huffbench_benchmark (void)
     if(huffbench_verify_benchmark(huffbench_benchmark_body(1)) != 1)
     {
       huffbench_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] huffbench: errnum=%u itr=%u\n", huffbench_errors, huffbench_executions);
+#if (RANDOM_INPUTS == 1)
+      huffbench_left = 0;
+      log_error_event("huffbench", huffbench_errors, huffbench_executions, " heap=%u seed=0x%08x", heap_error_beebs ((void *) beebs_heap), huffbench_seed);
+#else
+      log_error_event("huffbench", huffbench_errors, huffbench_executions, " heap=%u", heap_error_beebs ((void *) beebs_heap), 0);
+#endif
     }
   }
 }
@@ -508,10 +559,20 @@ static int __attribute__ ((noinline)) huffbench_benchmark_body (int rpt)
 
   for (j = 0; j < rpt; j++)
     {
-      init_heap_beebs ((void *) heap, HEAP_SIZE);
+      init_heap_beebs ((void *) beebs_heap, HEAP_SIZE);
 
       // initialization
+#if (RANDOM_INPUTS == 1)
+      if (0 == huffbench_left)
+	{
+	  huffbench_random_inputs ();
+	  huffbench_left = RANDOM_INPUTS_PERIOD;
+	}
+      huffbench_left--;
+      memcpy (test_data, random_data, TEST_SIZE * sizeof (random_data[0]));
+#else
       memcpy (test_data, orig_data, TEST_SIZE * sizeof (orig_data[0]));
+#endif
 
       // what we're timing
       compdecomp (test_data, TEST_SIZE);
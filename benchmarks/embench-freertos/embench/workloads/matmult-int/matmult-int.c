@@ -46,6 +46,26 @@
 #define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
 #endif
 
+/* Kernel variant, see KERNEL_* in support.h. The SIMD variant uses SSE2 or
+   AVX2 on a host build; on RISC-V it falls back to the autovec kernel until
+   a vector-capable core is available (hook below). */
+#ifndef MATMULT_KERNEL
+#define MATMULT_KERNEL KERNEL_SCALAR
+#endif
+
+#if (MATMULT_KERNEL == KERNEL_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MATMULT_SIMD_ISA 2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MATMULT_SIMD_ISA 1
+#elif defined(__riscv_vector)
+/* RVV hook: intrinsics for the row update go here. Until then the autovec
+   kernel is used, which GCC vectorises with -march=rv64gcv. */
+#endif
+#endif
+
 #include <stdio.h>
 unsigned int matmult_errors;
 unsigned int matmult_executions; 
@@ -77,11 +97,78 @@ int Seed;
 matrix ArrayA_ref, ArrayA, ArrayB_ref, ArrayB, ResultArray;
 
 void Multiply (matrix A, matrix B, matrix Res);
+void Multiply_autovec (matrix A, matrix B, matrix Res);
+void Multiply_simd (matrix A, matrix B, matrix Res);
 void InitSeed (void);
 void Test (matrix A, matrix B, matrix Res);
 void Initialize (matrix Array);
 int RandomInteger (void);
 
+#if (RANDOM_INPUTS == 1)
+/* One word per entry position, its halves go to A and B */
+static uint32_t matmult_rng;
+static uint32_t matmult_seed;
+static unsigned int matmult_left;
+
+/* Product of the current draw, kept once Freivalds' check has passed */
+static matrix matmult_expect;
+static int matmult_kept;
+
+/* New A and B for every draw, in place of the fixed ones. Entries have 13
+   bits, as the fixed inputs, so no sum of products overflows. */
+static void
+matmult_random_inputs (void)
+{
+  int i, j;
+
+  matmult_seed = matmult_rng;
+  for (i = 0; i < UPPERLIMIT; i++)
+    for (j = 0; j < UPPERLIMIT; j++)
+      {
+	uint32_t w = xorshift32_beebs (&matmult_rng);
+
+	ArrayA_ref[i][j] = w & 0x1fff;
+	ArrayB_ref[i][j] = (w >> 16) & 0x1fff;
+      }
+}
+
+/* Freivalds' check, A (B r) == Res r for a random vector r of bytes. A
+   wrong product passes with probability at most 1/256, for O(n^2) work. */
+static int
+matmult_freivalds (void)
+{
+  uint64_t r[UPPERLIMIT], br[UPPERLIMIT];
+  int i, j;
+
+  for (j = 0; j < UPPERLIMIT; j++)
+    r[j] = xorshift32_beebs (&matmult_rng) & 0xff;
+
+  for (i = 0; i < UPPERLIMIT; i++)
+    {
+      uint64_t sum = 0;
+
+      for (j = 0; j < UPPERLIMIT; j++)
+	sum += (uint64_t) ArrayB[i][j] * r[j];
+      br[i] = sum;
+    }
+
+  for (i = 0; i < UPPERLIMIT; i++)
+    {
+      uint64_t abr = 0, resr = 0;
+
+      for (j = 0; j < UPPERLIMIT; j++)
+	{
+	  abr += (uint64_t) ArrayA[i][j] * br[j];
+	  resr += (uint64_t) ResultArray[i][j] * r[j];
+	}
+      if (abr != resr)
+	return 0;
+    }
+
+  return 1;
+}
+#endif
+
 static int matmult_benchmark_body (int  rpt);
 
 void
@@ -103,7 +190,12 @@ matmult_benchmark (void)
     if(matmult_verify_benchmark(matmult_benchmark_body(1)) != 1)
     {
       matmult_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] matmult: errnum=%u itr=%u\n", matmult_errors, matmult_executions);
+#if (RANDOM_INPUTS == 1)
+      matmult_left = 0;
+      log_error_event("matmult", matmult_errors, matmult_executions, " seed=0x%08x", matmult_seed, 0);
+#else
+      log_error_event("matmult", matmult_errors, matmult_executions, NULL, 0, 0);
+#endif
     }
   }
 }
@@ -116,6 +208,15 @@ matmult_benchmark_body (int rpt)
 
   for (i = 0; i < rpt; i++)
     {
+#if (RANDOM_INPUTS == 1)
+      if (0 == matmult_left)
+	{
+	  matmult_random_inputs ();
+	  matmult_left = RANDOM_INPUTS_PERIOD;
+	  matmult_kept = 0;
+	}
+      matmult_left--;
+#endif
       memcpy (ArrayA, ArrayA_ref,
 	      UPPERLIMIT * UPPERLIMIT * sizeof (ArrayA[0][0]));
       memcpy (ArrayB, ArrayB_ref,
@@ -144,7 +245,13 @@ InitSeed (void)
 void
 Test (matrix A, matrix B, matrix Res)
 {
+#if defined(MATMULT_SIMD_ISA)
+  Multiply_simd (A, B, Res);
+#elif (MATMULT_KERNEL != KERNEL_SCALAR)
+  Multiply_autovec (A, B, Res);
+#else
   Multiply (A, B, Res);
+#endif
 }
 
 /*
@@ -174,6 +281,96 @@ Multiply (matrix A, matrix B, matrix Res)
       }
 }
 
+#if (MATMULT_KERNEL != KERNEL_SCALAR)
+
+/*
+ * Multiplies arrays A and B in i-k-j order: every step adds a scaled row of B
+ * to a row of Res, so the inner loop is unit-stride for both. The sums are
+ * formed in the same order as the reference, hence the same result.
+ */
+#if !defined(MATMULT_SIMD_ISA)
+void
+Multiply_autovec (matrix A, matrix B, matrix Res)
+{
+  int Outer, Inner, Index;
+
+  for (Outer = 0; Outer < UPPERLIMIT; Outer++)
+    {
+      long *restrict row = Res[Outer];
+
+      for (Inner = 0; Inner < UPPERLIMIT; Inner++)
+	row[Inner] = ZERO;
+      for (Index = 0; Index < UPPERLIMIT; Index++)
+	{
+	  const long scale = A[Outer][Index];
+	  const long *restrict brow = B[Index];
+
+	  for (Inner = 0; Inner < UPPERLIMIT; Inner++)
+	    row[Inner] += scale * brow[Inner];
+	}
+    }
+}
+
+#else
+
+/*
+ * Same i-k-j order with hand-written SIMD over 64-bit lanes. Neither SSE2 nor
+ * AVX2 has a 64x64-bit multiply, so the low half of the product is rebuilt
+ * from three 32x32-bit partial products, exact for any long operand.
+ */
+#if (MATMULT_SIMD_ISA == 2)
+typedef __m256i mm_vec_t;
+#define MM_VLEN 4
+#define mm_load(p) _mm256_loadu_si256 ((const __m256i *) (p))
+#define mm_store(p, v) _mm256_storeu_si256 ((__m256i *) (p), (v))
+#define mm_set1(x) _mm256_set1_epi64x (x)
+#define mm_zero() _mm256_setzero_si256 ()
+#define mm_add(x, y) _mm256_add_epi64 ((x), (y))
+#define mm_mul_epu32(x, y) _mm256_mul_epu32 ((x), (y))
+#define mm_srli(x, n) _mm256_srli_epi64 ((x), (n))
+#define mm_slli(x, n) _mm256_slli_epi64 ((x), (n))
+#else
+typedef __m128i mm_vec_t;
+#define MM_VLEN 2
+#define mm_load(p) _mm_loadu_si128 ((const __m128i *) (p))
+#define mm_store(p, v) _mm_storeu_si128 ((__m128i *) (p), (v))
+#define mm_set1(x) _mm_set1_epi64x (x)
+#define mm_zero() _mm_setzero_si128 ()
+#define mm_add(x, y) _mm_add_epi64 ((x), (y))
+#define mm_mul_epu32(x, y) _mm_mul_epu32 ((x), (y))
+#define mm_srli(x, n) _mm_srli_epi64 ((x), (n))
+#define mm_slli(x, n) _mm_slli_epi64 ((x), (n))
+#endif
+
+static inline mm_vec_t
+mm_mullo (mm_vec_t x, mm_vec_t y)
+{
+  mm_vec_t cross = mm_add (mm_mul_epu32 (mm_srli (x, 32), y),
+			   mm_mul_epu32 (x, mm_srli (y, 32)));
+
+  return mm_add (mm_mul_epu32 (x, y), mm_slli (cross, 32));
+}
+
+void
+Multiply_simd (matrix A, matrix B, matrix Res)
+{
+  int Outer, Inner, Index;
+
+  for (Outer = 0; Outer < UPPERLIMIT; Outer++)
+    for (Inner = 0; Inner < UPPERLIMIT; Inner += MM_VLEN)
+      {
+	mm_vec_t acc = mm_zero ();
+
+	for (Index = 0; Index < UPPERLIMIT; Index++)
+	  acc = mm_add (acc, mm_mullo (mm_set1 (A[Outer][Index]),
+				       mm_load (&B[Index][Inner])));
+	mm_store (&Res[Outer][Inner], acc);
+      }
+}
+
+#endif /* MATMULT_SIMD_ISA */
+#endif /* MATMULT_KERNEL != KERNEL_SCALAR */
+
 void
 matmult_initialise_benchmark ()
 {
@@ -187,6 +384,11 @@ matmult_initialise_benchmark ()
     for (InnerIndex = 0; InnerIndex < UPPERLIMIT; InnerIndex++)
       ArrayB_ref[OuterIndex][InnerIndex] = RANDOM_VALUE;
 
+#if (RANDOM_INPUTS == 1)
+  if (0 == matmult_rng)
+    matmult_rng = 0x6d6d756cU;
+  matmult_left = 0;
+#endif
   matmult_errors = 0;
   matmult_executions = 0;
 }
@@ -194,6 +396,20 @@ matmult_initialise_benchmark ()
 int
 matmult_verify_benchmark (int unused)
 {
+#if (RANDOM_INPUTS == 1)
+  /* The first execution checked after a draw is checked by Freivalds, the
+     others against its product */
+  if (!matmult_kept)
+    {
+      if (!matmult_freivalds ())
+	return 0;
+      memcpy (matmult_expect, ResultArray, sizeof (matmult_expect));
+      matmult_kept = 1;
+      return 1;
+    }
+
+  return 0 == memcmp (ResultArray, matmult_expect, sizeof (matmult_expect));
+#else
   int i, j;
   matrix exp = {
     {291018000, 315000075, 279049970, 205074215, 382719905,
@@ -280,6 +496,7 @@ matmult_verify_benchmark (int unused)
 
   return 0 == memcmp (ResultArray, exp,
 		      UPPERLIMIT * UPPERLIMIT * sizeof (exp[0][0]));
+#endif
 }
 
 
@@ -72,6 +72,26 @@
 #include <stdio.h>
 unsigned int nbody_errors;
 unsigned int nbody_executions; 
+unsigned int nbody_soa_errors;
+unsigned int nbody_soa_executions;
+
+/* Structure-of-arrays variant (nbody-soa workload). NBODY_SOA_BODIES is the
+   number of bodies, the 5 solar bodies followed by generated ones.
+   NBODY_SOA_LANES is the width of the blocked pairwise loop, NBODY_SOA_PARTS
+   the number of row partitions the O(n^2) loop is split into. */
+#ifndef NBODY_SOA_BODIES
+#define NBODY_SOA_BODIES 64
+#endif
+#ifndef NBODY_SOA_LANES
+#define NBODY_SOA_LANES 4
+#endif
+#ifndef NBODY_SOA_PARTS
+#define NBODY_SOA_PARTS 1
+#endif
+
+/* Relative tolerance against the golden energy, which is computed with the
+   reference loop and so sums in a different order */
+#define NBODY_SOA_REL_EPS 1.0e-12
 
 #define PI 3.141592653589793
 #define SOLAR_MASS ( 4 * PI * PI )
@@ -193,7 +213,7 @@ nbody_benchmark (void)
     if(nbody_verify_benchmark(nbody_benchmark_body(1)) != 1)
     {
       nbody_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] nbody: errnum=%u itr=%u\n", nbody_errors, nbody_executions);
+      log_error_event("nbody", nbody_errors, nbody_executions, NULL, 0, 0);
     }
   }
 }
@@ -313,6 +333,205 @@ nbody_get_executions (void)
 }
 
 
+// Structure-of-arrays variant
+
+/* One array per coordinate, padded with NBODY_SOA_LANES massless bodies far
+   away from the system so that the blocked inner loop can always run whole
+   blocks past the last body. */
+#define NBODY_SOA_SIZE (NBODY_SOA_BODIES + NBODY_SOA_LANES)
+
+static struct
+{
+  double x[NBODY_SOA_SIZE], y[NBODY_SOA_SIZE], z[NBODY_SOA_SIZE];
+  double vx[NBODY_SOA_SIZE], vy[NBODY_SOA_SIZE], vz[NBODY_SOA_SIZE];
+  double mass[NBODY_SOA_SIZE];
+} soa_bodies;
+
+/* Golden energy of the generated system */
+static double soa_golden_e;
+
+/* Energy from the last execution */
+static double soa_e;
+
+/* Generated bodies: small masses on orbits between 2 and 34 AU, using the
+   BEEBS generator so that the system is the same on every target */
+static double
+soa_uniform (double lo, double hi)
+{
+  return lo + (hi - lo) * (double) rand_beebs () / (double) RAND_MAX;
+}
+
+static void
+soa_generate_bodies (struct body *bodies)
+{
+  unsigned int i, k;
+
+  for (i = 0; i < NBODY_SOA_BODIES; i++)
+    {
+      if (i < (unsigned int) BODIES_SIZE)
+	{
+	  bodies[i] = solar_bodies[i];
+	  continue;
+	}
+
+      double r = soa_uniform (2.0, 34.0);
+      double a = soa_uniform (0.0, 2.0 * PI);
+      double speed = sqrt (SOLAR_MASS / r);
+
+      bodies[i].x[0] = r * cos (a);
+      bodies[i].x[1] = r * sin (a);
+      bodies[i].x[2] = soa_uniform (-0.5, 0.5);
+      bodies[i].v[0] = -speed * sin (a);
+      bodies[i].v[1] = speed * cos (a);
+      bodies[i].v[2] = soa_uniform (-0.05, 0.05);
+      bodies[i].mass = soa_uniform (1.0e-9, 1.0e-4) * SOLAR_MASS;
+    }
+
+  /* Recompute the sun velocity from scratch for the whole system */
+  for (k = 0; k < 3; k++)
+    bodies[0].v[k] = 0.0;
+  offset_momentum (bodies, NBODY_SOA_BODIES);
+}
+
+/* Energy contribution of the rows part, part + parts, part + 2 * parts...
+   Striding the rows keeps the triangular loop balanced between partitions,
+   and the partitions only read the body arrays, so each one can run on its
+   own hart with the caller adding the partial energies in part order. */
+double
+nbody_soa_energy_part (unsigned int part, unsigned int parts)
+{
+  double e = 0.0;
+  unsigned int i, j, l;
+
+  for (i = part; i < NBODY_SOA_BODIES; i += parts)
+    {
+      const double xi = soa_bodies.x[i];
+      const double yi = soa_bodies.y[i];
+      const double zi = soa_bodies.z[i];
+      double acc[NBODY_SOA_LANES] = { 0.0 };
+      double pot = 0.0;
+
+      e += soa_bodies.mass[i] * (soa_bodies.vx[i] * soa_bodies.vx[i]
+				 + soa_bodies.vy[i] * soa_bodies.vy[i]
+				 + soa_bodies.vz[i] * soa_bodies.vz[i]) / 2.;
+
+      /* Whole blocks of independent lanes, the tail reads the padding */
+      for (j = i + 1; j < NBODY_SOA_BODIES; j += NBODY_SOA_LANES)
+	for (l = 0; l < NBODY_SOA_LANES; l++)
+	  {
+	    double dx = xi - soa_bodies.x[j + l];
+	    double dy = yi - soa_bodies.y[j + l];
+	    double dz = zi - soa_bodies.z[j + l];
+
+	    acc[l] += soa_bodies.mass[j + l] / sqrt (dx * dx + dy * dy + dz * dz);
+	  }
+
+      for (l = 0; l < NBODY_SOA_LANES; l++)
+	pot += acc[l];
+      e -= soa_bodies.mass[i] * pot;
+    }
+
+  return e;
+}
+
+void
+nbody_soa_initialise_benchmark (void)
+{
+  static struct body bodies[NBODY_SOA_BODIES];
+  unsigned int i;
+
+  srand_beebs (0);
+  soa_generate_bodies (bodies);
+
+  for (i = 0; i < NBODY_SOA_SIZE; i++)
+    {
+      if (i < NBODY_SOA_BODIES)
+	{
+	  soa_bodies.x[i] = bodies[i].x[0];
+	  soa_bodies.y[i] = bodies[i].x[1];
+	  soa_bodies.z[i] = bodies[i].x[2];
+	  soa_bodies.vx[i] = bodies[i].v[0];
+	  soa_bodies.vy[i] = bodies[i].v[1];
+	  soa_bodies.vz[i] = bodies[i].v[2];
+	  soa_bodies.mass[i] = bodies[i].mass;
+	}
+      else
+	{
+	  soa_bodies.x[i] = 1.0e6 + i;
+	  soa_bodies.y[i] = 0.0;
+	  soa_bodies.z[i] = 0.0;
+	  soa_bodies.vx[i] = 0.0;
+	  soa_bodies.vy[i] = 0.0;
+	  soa_bodies.vz[i] = 0.0;
+	  soa_bodies.mass[i] = 0.0;
+	}
+    }
+
+  /* Golden value from the reference array-of-structs loop */
+  soa_golden_e = bodies_energy (bodies, NBODY_SOA_BODIES);
+
+  nbody_soa_errors = 0;
+  nbody_soa_executions = 0;
+}
+
+static int __attribute__ ((noinline))
+nbody_soa_benchmark_body (int rpt)
+{
+  int j;
+  unsigned int p;
+
+  for (j = 0; j < rpt; j++)
+    {
+      soa_e = 0.0;
+      for (p = 0; p < NBODY_SOA_PARTS; p++)
+	soa_e += nbody_soa_energy_part (p, NBODY_SOA_PARTS);
+    }
+
+  return 0;
+}
+
+void
+nbody_soa_warm_caches (int heat)
+{
+  int res = nbody_soa_benchmark_body (heat);
+
+  return;
+}
+
+int
+nbody_soa_verify_benchmark (int res __attribute ((unused)))
+{
+  return fabs (soa_e - soa_golden_e) <= NBODY_SOA_REL_EPS * fabs (soa_golden_e);
+}
+
+void
+nbody_soa_benchmark (void)
+{
+  for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
+  {
+    nbody_soa_executions++;
+    /* Execute once and check if different of correct */
+    if(nbody_soa_verify_benchmark(nbody_soa_benchmark_body(1)) != 1)
+    {
+      nbody_soa_errors++;
+      log_error_event("nbody-soa", nbody_soa_errors, nbody_soa_executions, NULL, 0, 0);
+    }
+  }
+}
+
+unsigned int
+nbody_soa_get_errors (void)
+{
+  return nbody_soa_errors;
+}
+
+unsigned int
+nbody_soa_get_executions (void)
+{
+  return nbody_soa_executions;
+}
+
+
 /*
    Local Variables:
    mode: C
@@ -42,6 +42,17 @@ int nbody_verify_benchmark(int res);
 unsigned int nbody_get_errors(void);
 unsigned int nbody_get_executions(void);
 
+/* Structure-of-arrays variant with NBODY_SOA_BODIES bodies */
+void nbody_soa_initialise_benchmark(void);
+void nbody_soa_warm_caches(int temperature);
+void nbody_soa_benchmark(void) __attribute__ ((noinline));
+int nbody_soa_verify_benchmark(int res);
+unsigned int nbody_soa_get_errors(void);
+unsigned int nbody_soa_get_executions(void);
+
+/* Energy of one row partition, for splitting the pairwise loop over harts */
+double nbody_soa_energy_part(unsigned int part, unsigned int parts);
+
 /* Local simplified versions of library functions */
 
 #endif /* NBODY_H */
@@ -104,7 +104,7 @@ nsichneu_benchmark (void)
     if(nsichneu_verify_benchmark(nsichneu_benchmark_body(1)) != 1)
     {
       nsichneu_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] nsichneu: errnum=%u itr=%u\n", nsichneu_errors, nsichneu_executions);
+      log_error_event("nsichneu", nsichneu_errors, nsichneu_executions, NULL, 0, 0);
     }
   }
 }
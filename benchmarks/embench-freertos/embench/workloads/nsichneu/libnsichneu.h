@@ -42,6 +42,14 @@ int nsichneu_verify_benchmark(int res);
 unsigned int nsichneu_get_errors(void);
 unsigned int nsichneu_get_executions(void);
 
+/* Bit-parallel engine (nsichneu-bits workload), in libnsichneu_bits.c */
+void nsichneu_bits_initialise_benchmark(void);
+void nsichneu_bits_warm_caches(int temperature);
+void nsichneu_bits_benchmark(void) __attribute__ ((noinline));
+int nsichneu_bits_verify_benchmark(int res);
+unsigned int nsichneu_bits_get_errors(void);
+unsigned int nsichneu_bits_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* LIBNSICHNEU_H */
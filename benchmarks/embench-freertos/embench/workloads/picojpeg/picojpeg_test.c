@@ -11,9 +11,11 @@
 
    SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include "inc/common.h"
 #include <embench/support.h>
 #include "picojpeg.h"
 
+#include <stdint.h>
 #include <string.h>
 
 /* This scale factor will be changed to equalise the runtime of the
@@ -22,9 +24,26 @@
 #define LOCAL_SCALE_FACTOR 1
 #else
 #define LOCAL_SCALE_FACTOR 1
+#define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
 // #define LOCAL_SCALE_FACTOR 6
 #endif
 
+/* Streaming variant (picojpeg-stream workload): the decoder reads the image
+   through a ring buffer of PICOJPEG_RING_SIZE bytes (a power of two), and
+   each MCU is checked against a rolling signature. */
+#ifndef PICOJPEG_RING_SIZE
+#define PICOJPEG_RING_SIZE 64
+#endif
+
+#if (PICOJPEG_RING_SIZE & (PICOJPEG_RING_SIZE - 1)) != 0
+#error "PICOJPEG_RING_SIZE must be a power of two"
+#endif
+
+unsigned int picojpeg_errors;
+unsigned int picojpeg_executions;
+unsigned int picojpeg_stream_errors;
+unsigned int picojpeg_stream_executions;
+
 const unsigned char jpeg_data[] = {
   0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46,
   0x49, 0x46, 0x00, 0x01, 0x01, 0x01, 0x00, 0x48,
@@ -164,6 +183,8 @@ picojpeg_verify_benchmark(int res __attribute ((unused)))
 void
 picojpeg_initialise_benchmark (void)
 {
+  picojpeg_errors = 0;
+  picojpeg_executions = 0;
 }
 
 
@@ -178,10 +199,19 @@ picojpeg_warm_caches (int  heat)
 }
 
 
-int
+void
 picojpeg_benchmark (void)
 {
-  return picojpeg_benchmark_body (LOCAL_SCALE_FACTOR * CPU_MHZ);
+  for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
+  {
+    picojpeg_executions++;
+    /* Execute once and check if different of correct */
+    if(picojpeg_verify_benchmark(picojpeg_benchmark_body(1)) != 1)
+    {
+      picojpeg_errors++;
+      log_error_event("picojpeg", picojpeg_errors, picojpeg_executions, NULL, 0, 0);
+    }
+  }
 }
 
 
@@ -210,6 +240,183 @@ picojpeg_benchmark_body (int rpt)
   return 0;
 }
 
+unsigned int
+picojpeg_get_errors (void)
+{
+  return picojpeg_errors;
+}
+
+unsigned int
+picojpeg_get_executions (void)
+{
+  return picojpeg_executions;
+}
+
+
+// Streaming variant
+
+/* Input ring, filled from jpeg_data as a peripheral would fill it, and
+   drained by the decoder callback */
+
+static struct
+{
+  unsigned char buf[PICOJPEG_RING_SIZE];
+  unsigned int head;		/* next byte to write */
+  unsigned int tail;		/* next byte to read */
+  unsigned int src_off;		/* next byte of jpeg_data to stream in */
+} jpeg_ring;
+
+/* Rolling signature after each MCU of the test image: FNV-1a over the R,
+   G and B blocks of the MCU, seeded with the signature of the previous MCU */
+
+#define PICOJPEG_MCUS 56
+
+static const uint32_t mcu_sig[PICOJPEG_MCUS] = {
+  0x69891c95, 0x23128d15, 0xd15dff63, 0x3c32ab46, 0xd2f37ef1, 0xeaf84835,
+  0x89011d75, 0x70371825, 0xdc3a563e, 0x3c7eb54d, 0x9e4ca805, 0xd1a37ecf,
+  0x0f9ef49b, 0x189ce0a3, 0x723ad123, 0xd4d8b054, 0xef769ae7, 0x2d06629a,
+  0xd8903435, 0x2f99a519, 0x2d347da1, 0xf8e90ea1, 0xeb5bc3ae, 0x37469fd3,
+  0x0a4a5ffa, 0x471ad87e, 0xee4c39ea, 0xecdd705c, 0x4416100c, 0x2b77c4c7,
+  0xeb225347, 0x1bf1c298, 0x690c6397, 0x0903e69f, 0x8caefe5f, 0x7765f2bf,
+  0xded37b96, 0xf6a1bf4a, 0x50f123a0, 0x37599a16, 0x419b9483, 0x0f21e481,
+  0xf2f60d66, 0xf9060d21, 0x832d7746, 0x62c5ac9c, 0x4dea4072, 0x3cb2fb97,
+  0xbbb439ff, 0xb58e23f2, 0x0f8916fb, 0x72e830f6, 0x0268a005, 0x419f4a08,
+  0xded713dd, 0x66f5576d
+};
+
+/* Result of the last decode */
+
+static unsigned int stream_mcus;
+static unsigned int stream_bad_mcu;
+
+static void
+jpeg_ring_fill (void)
+{
+  while ((jpeg_ring.head - jpeg_ring.tail < PICOJPEG_RING_SIZE)
+	 && (jpeg_ring.src_off < sizeof (jpeg_data)))
+    jpeg_ring.buf[jpeg_ring.head++ & (PICOJPEG_RING_SIZE - 1)] =
+      jpeg_data[jpeg_ring.src_off++];
+}
+
+unsigned char
+pjpeg_need_bytes_ring_callback (unsigned char *pBuf,
+				unsigned char buf_size,
+				unsigned char *pBytes_actually_read,
+				void *pCallback_data __attribute ((unused)))
+{
+  unsigned int n;
+
+  if (jpeg_ring.head == jpeg_ring.tail)
+    jpeg_ring_fill ();
+
+  for (n = 0; (n < buf_size) && (jpeg_ring.tail != jpeg_ring.head); n++)
+    pBuf[n] = jpeg_ring.buf[jpeg_ring.tail++ & (PICOJPEG_RING_SIZE - 1)];
+
+  *pBytes_actually_read = (unsigned char) n;
+  return 0;
+}
+
+static uint32_t
+mcu_signature (uint32_t sig, const pjpeg_image_info_t *info)
+{
+  const unsigned int len = info->m_MCUWidth * info->m_MCUHeight;
+  unsigned int i;
+
+  for (i = 0; i < len; i++)
+    {
+      sig = (sig ^ info->m_pMCUBufR[i]) * 16777619U;
+      sig = (sig ^ info->m_pMCUBufG[i]) * 16777619U;
+      sig = (sig ^ info->m_pMCUBufB[i]) * 16777619U;
+    }
+
+  return sig;
+}
+
+void
+picojpeg_stream_initialise_benchmark (void)
+{
+  picojpeg_stream_errors = 0;
+  picojpeg_stream_executions = 0;
+}
+
+/* Returns the number of MCUs that did not match their signature */
+
+static int __attribute__ ((noinline))
+picojpeg_stream_benchmark_body (int rpt)
+{
+  int i, bad = 0;
+
+  for (i = 0; i < rpt; i++)
+    {
+      uint32_t sig = 2166136261U;
+
+      jpeg_ring.head = 0;
+      jpeg_ring.tail = 0;
+      jpeg_ring.src_off = 0;
+      stream_mcus = 0;
+      stream_bad_mcu = PICOJPEG_MCUS;
+      bad = 0;
+
+      if (0 != pjpeg_decode_init (&pInfo, pjpeg_need_bytes_ring_callback, 0, 0))
+	return PICOJPEG_MCUS;
+
+      while (0 == pjpeg_decode_mcu ())
+	{
+	  sig = mcu_signature (sig, &pInfo);
+
+	  if ((stream_mcus >= PICOJPEG_MCUS) || (sig != mcu_sig[stream_mcus]))
+	    {
+	      if (0 == bad++)
+		stream_bad_mcu = stream_mcus;
+	    }
+	  stream_mcus++;
+	}
+    }
+
+  return bad;
+}
+
+void
+picojpeg_stream_warm_caches (int heat)
+{
+  int res = picojpeg_stream_benchmark_body (heat);
+
+  return;
+}
+
+int
+picojpeg_stream_verify_benchmark (int res)
+{
+  return (0 == res) && (PICOJPEG_MCUS == stream_mcus);
+}
+
+void
+picojpeg_stream_benchmark (void)
+{
+  for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
+  {
+    picojpeg_stream_executions++;
+    /* Execute once and check if different of correct */
+    if(picojpeg_stream_verify_benchmark(picojpeg_stream_benchmark_body(1)) != 1)
+    {
+      picojpeg_stream_errors++;
+      log_error_event("picojpeg-stream", picojpeg_stream_errors, picojpeg_stream_executions, " mcu=%u", stream_bad_mcu, 0);
+    }
+  }
+}
+
+unsigned int
+picojpeg_stream_get_errors (void)
+{
+  return picojpeg_stream_errors;
+}
+
+unsigned int
+picojpeg_stream_get_executions (void)
+{
+  return picojpeg_stream_executions;
+}
+
 
 /*
    Local Variables:
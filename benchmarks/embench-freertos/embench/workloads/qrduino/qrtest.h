@@ -35,13 +35,25 @@ void qrduino_warm_caches(int temperature);
 /* Every benchmark implements this as its entry point. Don't allow it to be
    inlined! */
 
-int qrduino_benchmark(void) __attribute__ ((noinline));
+void qrduino_benchmark(void) __attribute__ ((noinline));
 
 /* Every benchmark must implement this to validate the result of the
    benchmark. */
 
 int qrduino_verify_benchmark(int res);
 
+/* Custom functions to allow checking each of the N executions of the benchmark */
+unsigned int qrduino_get_errors(void);
+unsigned int qrduino_get_executions(void);
+
+/* Low-footprint variant, encoding rotating payloads in a fixed buffer */
+void qrduino_lite_initialise_benchmark(void);
+void qrduino_lite_warm_caches(int temperature);
+void qrduino_lite_benchmark(void) __attribute__ ((noinline));
+int qrduino_lite_verify_benchmark(int res);
+unsigned int qrduino_lite_get_errors(void);
+unsigned int qrduino_lite_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* QRTEST_H */
@@ -29,14 +29,21 @@
 unsigned int sglib_errors;
 unsigned int sglib_executions; 
 
-/* BEEBS heap is just an array */
+/* BEEBS heap is just an array. Each iteration allocates up to 300 nodes of
+   at most 24 bytes, each with 16 bytes of header and canary. */
 
-#define HEAP_SIZE 8192
+#define HEAP_SIZE 16384
 static char heap[HEAP_SIZE];
 
-/* General array to sort for all ops */
+/* General array to sort for all ops. It is a permutation of 0 to 99, which
+   the checks rely on rather than on its order: with RANDOM_INPUTS it is
+   shuffled again for every draw. */
 
+#if (RANDOM_INPUTS == 1)
+static int array[100] = {
+#else
 static const int array[100] = {
+#endif
   14, 66, 12, 41, 86, 69, 19, 77, 68, 38,
   26, 42, 37, 23, 17, 29, 55, 13, 90, 92,
   76, 99, 10, 54, 57, 83, 40, 44, 75, 33,
@@ -49,6 +56,29 @@ static const int array[100] = {
   62, 97,  2, 79, 98, 25, 22, 65, 71,  0
 };
 
+#if (RANDOM_INPUTS == 1)
+/* One word per swap of the shuffle */
+static uint32_t sglib_rng;
+static uint32_t sglib_seed;
+static unsigned int sglib_left;
+
+/* Fisher-Yates, an index below i + 1 is taken from the top bits of a word */
+static void
+sglib_random_inputs (void)
+{
+  int i, j, t;
+
+  sglib_seed = sglib_rng;
+  for (i = 99; i > 0; i--)
+    {
+      j = (int) (((uint64_t) xorshift32_beebs (&sglib_rng) * (i + 1)) >> 32);
+      t = array[i];
+      array[i] = array[j];
+      array[j] = t;
+    }
+}
+#endif
+
 /* Array quicksort declarations */
 
 int array2[100];
@@ -174,6 +204,11 @@ sglib_verify_benchmark (int res)
 void
 sglib_initialise_benchmark (void)
 {
+#if (RANDOM_INPUTS == 1)
+  if (0 == sglib_rng)
+    sglib_rng = 0x73676c62U;
+  sglib_left = 0;
+#endif
   sglib_errors = 0;
   sglib_executions = 0;
 }
@@ -201,7 +236,12 @@ sglib_benchmark (void)
     if(sglib_verify_benchmark(sglib_benchmark_body(1)) != 1)
     {
       sglib_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] sglib: errnum=%u itr=%u\n", sglib_errors, sglib_executions);
+#if (RANDOM_INPUTS == 1)
+      sglib_left = 0;
+      log_error_event("sglib", sglib_errors, sglib_executions, " heap=%u seed=0x%08x", heap_error_beebs ((void *) heap), sglib_seed);
+#else
+      log_error_event("sglib", sglib_errors, sglib_executions, " heap=%u", heap_error_beebs ((void *) heap), 0);
+#endif
     }
   }
 }
@@ -226,6 +266,14 @@ sglib_benchmark_body (int rpt)
 
       /* Array quicksort */
 
+#if (RANDOM_INPUTS == 1)
+      if (0 == sglib_left)
+	{
+	  sglib_random_inputs ();
+	  sglib_left = RANDOM_INPUTS_PERIOD;
+	}
+      sglib_left--;
+#endif
       memcpy (array2, array, 100 * sizeof (array[0]));
       SGLIB_ARRAY_SINGLE_QUICK_SORT (int, array2, 100,
 				     SGLIB_NUMERIC_COMPARATOR);
@@ -237,7 +285,9 @@ sglib_benchmark_body (int rpt)
 
       for (i = 0; i < 100; ++i)
 	{
-	  l = malloc_beebs (sizeof (dllist));
+	  l = malloc_arena_beebs ((void *) heap, sizeof (dllist));
+	  if (NULL == l)
+	    return 0;
 	  l->i = array[i];
 	  sglib_dllist_add (&the_list, l);
 	}
@@ -259,7 +309,9 @@ sglib_benchmark_body (int rpt)
 	  ii.i = array[i];
 	  if (sglib_hashed_ilist_find_member (htab, &ii) == NULL)
 	    {
-	      nn = malloc_beebs (sizeof (struct ilist));
+	      nn = malloc_arena_beebs ((void *) heap, sizeof (struct ilist));
+	      if (NULL == nn)
+		return 0;
 	      nn->i = array[i];
 	      sglib_hashed_ilist_add (htab, nn);
 	    }
@@ -309,7 +361,9 @@ sglib_benchmark_body (int rpt)
 	  e.n = array[i];
 	  if (sglib_rbtree_find_member (the_tree, &e) == NULL)
 	    {
-	      t = malloc_beebs (sizeof (struct rbtree));
+	      t = malloc_arena_beebs ((void *) heap, sizeof (struct rbtree));
+	      if (NULL == t)
+		return 0;
 	      t->n = array[i];
 	      sglib_rbtree_add (&the_tree, t);
 	    }
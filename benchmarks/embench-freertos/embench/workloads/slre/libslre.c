@@ -28,12 +28,15 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "slre.h"
 
 unsigned int slre_errors;
 unsigned int slre_executions; 
+unsigned int slre_dfa_errors;
+unsigned int slre_dfa_executions;
 
 #define MAX_BRANCHES 100
 #define MAX_BRACKETS 100
@@ -569,6 +572,453 @@ slre_match (const char *regexp, const char *s, int s_len,
   return foo (regexp, strlen (regexp), s, s_len, &info);
 }
 
+/* Compiled matcher (slre-dfa workload).
+
+   A pattern is compiled once into a Thompson NFA and then, by subset
+   construction, into a DFA over byte classes.  Matching is a table walk from
+   every start position, keeping the longest match of the leftmost start, and
+   returns its end offset.  Character semantics come from match_op () and
+   match_set () so both engines agree on every byte.
+
+   slre_match () backtracks and takes the first alternative that matches, so
+   the two differ when a shorter alternative comes first: "(a|ab)" on "ab"
+   ends at 1 there and at 2 here.  The workload patterns are checked to agree
+   at initialisation.
+
+   Captures, non-greedy quantifiers and anchors other than a leading '^' and
+   a trailing '$' are not supported. */
+
+#ifndef SLRE_NFA_STATES
+#define SLRE_NFA_STATES 64	/* At most 64, NFA state sets are 64-bit masks */
+#endif
+#ifndef SLRE_DFA_STATES
+#define SLRE_DFA_STATES 32	/* Including the dead state 0 */
+#endif
+#ifndef SLRE_DFA_CLASSES
+#define SLRE_DFA_CLASSES 16
+#endif
+
+#define SLRE_DFA_UNSUPPORTED -10
+#define SLRE_DFA_TOO_LARGE   -11
+
+struct slre_dfa
+{
+  unsigned char classmap[256];	/* Byte to class                          */
+  unsigned char delta[SLRE_DFA_STATES][SLRE_DFA_CLASSES];
+  unsigned char accept[SLRE_DFA_STATES];
+  unsigned char anchored_start;
+  unsigned char anchored_end;
+  unsigned char num_states;
+  unsigned char num_classes;
+};
+
+enum
+{ NFA_SET, NFA_SPLIT, NFA_MATCH };
+
+struct slre_nfa
+{
+  unsigned char type[SLRE_NFA_STATES];
+  short out[SLRE_NFA_STATES];	/* Next state, or patch list link   */
+  short out1[SLRE_NFA_STATES];	/* Second branch of NFA_SPLIT       */
+  uint32_t set[SLRE_NFA_STATES][8];	/* Bytes accepted by NFA_SET        */
+  int num_states;
+
+  const char *re;
+  int pos, len, depth;
+  int top_branches;
+  int error;
+  struct regex_info *info;
+};
+
+/* A fragment is a start state and a list of unpatched exits, threaded
+   through the out fields as (state << 1 | is_out1) */
+
+struct nfa_frag
+{
+  int start;
+  int exits;
+};
+
+static int
+nfa_state (struct slre_nfa *n, int type, int out, int out1)
+{
+  if (n->num_states >= SLRE_NFA_STATES)
+    {
+      n->error = SLRE_DFA_TOO_LARGE;
+      return -1;
+    }
+
+  n->type[n->num_states] = type;
+  n->out[n->num_states] = out;
+  n->out1[n->num_states] = out1;
+  memset (n->set[n->num_states], 0, sizeof (n->set[0]));
+
+  return n->num_states++;
+}
+
+static short *
+nfa_exit (struct slre_nfa *n, int exit)
+{
+  return exit & 1 ? &n->out1[exit >> 1] : &n->out[exit >> 1];
+}
+
+static void
+nfa_patch (struct slre_nfa *n, int exits, int target)
+{
+  while (exits >= 0)
+    {
+      short *slot = nfa_exit (n, exits);
+
+      exits = *slot;
+      *slot = target;
+    }
+}
+
+static int
+nfa_append (struct slre_nfa *n, int exits, int more)
+{
+  int last = exits;
+
+  if (exits < 0)
+    return more;
+
+  while (*nfa_exit (n, last) >= 0)
+    last = *nfa_exit (n, last);
+  *nfa_exit (n, last) = more;
+
+  return exits;
+}
+
+static struct nfa_frag nfa_alt (struct slre_nfa *n);
+
+static struct nfa_frag
+nfa_atom (struct slre_nfa *n)
+{
+  struct nfa_frag f = { -1, -1 };
+  const char *re = n->re + n->pos;
+  int b, step, s;
+
+  if (is_quantifier (re))
+    {
+      n->error = SLRE_UNEXPECTED_QUANTIFIER;
+      return f;
+    }
+
+  if (re[0] == '(')
+    {
+      n->pos++;
+      n->depth++;
+      f = nfa_alt (n);
+      n->depth--;
+      if (n->error == 0 && (n->pos >= n->len || n->re[n->pos] != ')'))
+	n->error = SLRE_UNBALANCED_BRACKETS;
+      n->pos++;
+      return f;
+    }
+
+  if (re[0] == '^' || re[0] == '$')
+    {
+      n->error = SLRE_DFA_UNSUPPORTED;
+      return f;
+    }
+
+  if (re[0] == '\\' && n->pos + 1 < n->len
+      && (re[1] == 'x' ? n->pos + 3 >= n->len
+	  || !(isxdigit ((unsigned char) re[2])
+	       && isxdigit ((unsigned char) re[3]))
+	  : !is_metacharacter ((const unsigned char *) re + 1)))
+    {
+      n->error = SLRE_INVALID_METACHARACTER;
+      return f;
+    }
+
+  step = get_op_len (re, n->len - n->pos);
+  if (step <= 0 || step > n->len - n->pos)
+    {
+      n->error = SLRE_INVALID_CHARACTER_SET;
+      return f;
+    }
+
+  s = nfa_state (n, NFA_SET, -1, -1);
+  if (s < 0)
+    return f;
+
+  for (b = 1; b < 256; b++)
+    {
+      char c = (char) b;
+      int hit = re[0] == '[' ?
+	match_set (re + 1, n->len - n->pos - 2, &c, n->info) > 0 :
+	match_op ((const unsigned char *) re, (const unsigned char *) &c,
+		  n->info) > 0;
+
+      if (hit)
+	n->set[s][b >> 5] |= (uint32_t) 1 << (b & 31);
+    }
+
+  n->pos += step;
+  f.start = s;
+  f.exits = s << 1;
+
+  return f;
+}
+
+static struct nfa_frag
+nfa_repeat (struct slre_nfa *n)
+{
+  struct nfa_frag f = nfa_atom (n);
+  char q;
+  int s;
+
+  if (n->error != 0 || n->pos >= n->len || !is_quantifier (n->re + n->pos))
+    return f;
+
+  q = n->re[n->pos++];
+  if (q != '?' && n->pos < n->len && n->re[n->pos] == '?')
+    {
+      /* Non-greedy */
+      n->error = SLRE_DFA_UNSUPPORTED;
+      return f;
+    }
+
+  s = nfa_state (n, NFA_SPLIT, f.start, -1);
+  if (s < 0)
+    return f;
+
+  switch (q)
+    {
+    case '*':
+      nfa_patch (n, f.exits, s);
+      f.start = s;
+      f.exits = s << 1 | 1;
+      break;
+
+    case '+':
+      nfa_patch (n, f.exits, s);
+      f.exits = s << 1 | 1;
+      break;
+
+    default:
+      f.start = s;
+      f.exits = nfa_append (n, f.exits, s << 1 | 1);
+      break;
+    }
+
+  return f;
+}
+
+static struct nfa_frag
+nfa_concat (struct slre_nfa *n)
+{
+  struct nfa_frag f = { -1, -1 }, g;
+
+  while (n->error == 0 && n->pos < n->len
+	 && n->re[n->pos] != '|' && n->re[n->pos] != ')')
+    {
+      g = nfa_repeat (n);
+      if (n->error != 0)
+	break;
+      if (f.start < 0)
+	f = g;
+      else
+	{
+	  nfa_patch (n, f.exits, g.start);
+	  f.exits = g.exits;
+	}
+    }
+
+  /* Empty branches and "()" are left to the interpreter */
+  if (n->error == 0 && f.start < 0)
+    n->error = SLRE_DFA_UNSUPPORTED;
+
+  return f;
+}
+
+static struct nfa_frag
+nfa_alt (struct slre_nfa *n)
+{
+  struct nfa_frag f = nfa_concat (n), g;
+  int s;
+
+  while (n->error == 0 && n->pos < n->len && n->re[n->pos] == '|')
+    {
+      n->pos++;
+      if (n->depth == 0)
+	n->top_branches++;
+      g = nfa_concat (n);
+      if (n->error != 0)
+	break;
+      s = nfa_state (n, NFA_SPLIT, f.start, g.start);
+      if (s < 0)
+	break;
+      f.start = s;
+      f.exits = nfa_append (n, f.exits, g.exits);
+    }
+
+  return f;
+}
+
+/* Adds state s and the states reachable from it without input */
+
+static void
+nfa_close (const struct slre_nfa *n, int s, uint64_t *set)
+{
+  while (s >= 0 && !((*set >> s) & 1))
+    {
+      *set |= (uint64_t) 1 << s;
+      if (n->type[s] != NFA_SPLIT)
+	break;
+      nfa_close (n, n->out1[s], set);
+      s = n->out[s];
+    }
+}
+
+/* Compiles regexp into dfa, returns 0 or a negative error code. */
+
+static int
+slre_dfa_compile (struct slre_dfa *dfa, const char *regexp)
+{
+  static struct slre_nfa n;
+  static struct regex_info info;
+  uint64_t class_sig[SLRE_DFA_CLASSES];
+  uint64_t dset[SLRE_DFA_STATES];
+  struct nfa_frag f;
+  int b, c, d, k, match;
+
+  memset (dfa, 0, sizeof (*dfa));
+  memset (&n, 0, sizeof (n));
+  info.flags = 0;
+
+  if (memcmp (regexp, "(?i)", 4) == 0)
+    {
+      info.flags |= IGNORE_CASE;
+      regexp += 4;
+    }
+
+  n.re = regexp;
+  n.len = strlen (regexp);
+  n.info = &info;
+
+  if (n.len > 0 && regexp[0] == '^')
+    {
+      dfa->anchored_start = 1;
+      n.pos = 1;
+    }
+  if (n.len > n.pos && regexp[n.len - 1] == '$'
+      && (n.len < 2 || regexp[n.len - 2] != '\\'))
+    {
+      dfa->anchored_end = 1;
+      n.len--;
+    }
+
+  f = nfa_alt (&n);
+  if (n.error == 0 && n.pos != n.len)
+    n.error = SLRE_UNBALANCED_BRACKETS;
+  if (n.error == 0 && n.top_branches > 0
+      && (dfa->anchored_start || dfa->anchored_end))
+    n.error = SLRE_DFA_UNSUPPORTED;
+  if (n.error != 0)
+    return n.error;
+
+  match = nfa_state (&n, NFA_MATCH, -1, -1);
+  if (match < 0)
+    return n.error;
+  nfa_patch (&n, f.exits, match);
+
+  /* Bytes accepted by the same NFA states share a class */
+  dfa->num_classes = 0;
+  for (b = 0; b < 256; b++)
+    {
+      uint64_t sig = 0;
+
+      for (k = 0; k < n.num_states; k++)
+	if (n.type[k] == NFA_SET && ((n.set[k][b >> 5] >> (b & 31)) & 1))
+	  sig |= (uint64_t) 1 << k;
+
+      for (c = 0; c < dfa->num_classes && class_sig[c] != sig; c++)
+	;
+      if (c == dfa->num_classes)
+	{
+	  if (c == SLRE_DFA_CLASSES)
+	    return SLRE_DFA_TOO_LARGE;
+	  class_sig[dfa->num_classes++] = sig;
+	}
+      dfa->classmap[b] = c;
+    }
+
+  /* Subset construction, state 0 is dead and state 1 the start */
+  dset[0] = 0;
+  dset[1] = 0;
+  nfa_close (&n, f.start, &dset[1]);
+  dfa->num_states = 2;
+
+  for (d = 1; d < dfa->num_states; d++)
+    {
+      dfa->accept[d] = (dset[d] >> match) & 1;
+
+      for (c = 0; c < dfa->num_classes; c++)
+	{
+	  uint64_t next = 0;
+	  int t;
+
+	  for (k = 0; k < n.num_states; k++)
+	    if (((dset[d] & class_sig[c]) >> k) & 1)
+	      nfa_close (&n, n.out[k], &next);
+
+	  for (t = 0; t < dfa->num_states && dset[t] != next; t++)
+	    ;
+	  if (t == dfa->num_states)
+	    {
+	      if (t == SLRE_DFA_STATES)
+		return SLRE_DFA_TOO_LARGE;
+	      dset[dfa->num_states++] = next;
+	    }
+	  dfa->delta[d][c] = t;
+	}
+    }
+
+  return 0;
+}
+
+/* End offset of the leftmost-longest match or SLRE_NO_MATCH */
+
+static int
+slre_dfa_match (const struct slre_dfa *dfa, const char *s, int s_len)
+{
+  const unsigned char *p = (const unsigned char *) s;
+  int i, j, last, state;
+
+  for (i = 0; i <= s_len; i++)
+    {
+      /* Skip start positions the first byte already rules out */
+      if (i < s_len && dfa->delta[1][dfa->classmap[p[i]]] == 0
+	  && !dfa->accept[1])
+	{
+	  if (dfa->anchored_start)
+	    break;
+	  continue;
+	}
+
+      last = dfa->accept[1] ? i : -1;
+      for (state = 1, j = i; j < s_len; j++)
+	{
+	  state = dfa->delta[state][dfa->classmap[p[j]]];
+	  if (state == 0)
+	    break;
+	  if (dfa->accept[state])
+	    last = j + 1;
+	}
+
+      if (dfa->anchored_end)
+	last = j == s_len && dfa->accept[state] ? j : -1;
+      if (last >= 0)
+	return last;
+      if (dfa->anchored_start)
+	break;
+    }
+
+  return SLRE_NO_MATCH;
+}
+
 char text[] = "abbbababaabccababcacbcbcbabbabcbabcabcbbcbbac";
 char *regexes[] = { "(ab)+", "(b.+)+", "a[ab]*", "([ab^c][ab^c])+" };
 
@@ -601,7 +1051,7 @@ slre_benchmark (void)
     if(slre_verify_benchmark(slre_benchmark_body(1)) != 1)
     {
       slre_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] slre: errnum=%u itr=%u\n", slre_errors, slre_executions);
+      log_error_event("slre", slre_errors, slre_executions, NULL, 0, 0);
     }
   }
 }
@@ -649,6 +1099,154 @@ slre_get_executions (void)
 }
 
 
+// Compiled matcher
+
+/* Every pattern is matched against every text */
+
+#define SLRE_DFA_PATTERNS 12
+#define SLRE_DFA_TEXTS     4
+
+static const char *const dfa_regexes[SLRE_DFA_PATTERNS] = {
+  "(ab)+", "(b.+)+", "a[ab]*", "([ab^c][ab^c])+",
+  "\\d+", "[a-z]+=\\d+", "\\s+\\S+", "(GET|POST|PUT) \\S+",
+  "(?i)host: *[a-z\\.]+", "0[xX][0-9a-fA-F]+", "status=(OK|FAIL)$", "^\\S+"
+};
+
+static const char *const dfa_texts[SLRE_DFA_TEXTS] = {
+  "abbbababaabccababcacbcbcbabbabcbabcabcbbcbbac",
+  "GET /index.html HTTP/1.1\r\nHost: www.embench.org\r\n",
+  "temp=35C volt=1 hart=3 cycle=000042 status=OK",
+  "0x1F 0x2e 0XAB 12345 abc-def_ghi 987654321"
+};
+
+static struct slre_dfa dfa_compiled[SLRE_DFA_PATTERNS];
+static int dfa_text_len[SLRE_DFA_TEXTS];
+
+/* slre_match () results, the reference for every execution */
+static int dfa_golden[SLRE_DFA_PATTERNS * SLRE_DFA_TEXTS];
+
+/* Patterns that did not compile or disagreed with slre_match () on the
+   texts or any of their suffixes */
+static unsigned int dfa_init_errors;
+
+/* First pattern/text pair that failed in the last execution */
+static int dfa_first_bad;
+
+void
+slre_dfa_initialise_benchmark (void)
+{
+  int p, t, i;
+
+  slre_dfa_errors = 0;
+  slre_dfa_executions = 0;
+  dfa_init_errors = 0;
+
+  for (t = 0; t < SLRE_DFA_TEXTS; t++)
+    dfa_text_len[t] = strlen (dfa_texts[t]);
+
+  for (p = 0; p < SLRE_DFA_PATTERNS; p++)
+    {
+      int ok = 0 == slre_dfa_compile (&dfa_compiled[p], dfa_regexes[p]);
+
+      for (t = 0; t < SLRE_DFA_TEXTS; t++)
+	{
+	  int k = p * SLRE_DFA_TEXTS + t;
+
+	  dfa_golden[k] = slre_match (dfa_regexes[p], dfa_texts[t],
+				      dfa_text_len[t], NULL, 0);
+
+	  /* Every start offset, not only the reference pairs */
+	  for (i = 0; ok && i <= dfa_text_len[t]; i++)
+	    ok = slre_match (dfa_regexes[p], dfa_texts[t] + i,
+			     dfa_text_len[t] - i, NULL, 0)
+	      == slre_dfa_match (&dfa_compiled[p], dfa_texts[t] + i,
+				 dfa_text_len[t] - i);
+	}
+
+      dfa_init_errors += !ok;
+    }
+}
+
+
+static int slre_dfa_benchmark_body (int  rpt);
+
+void
+slre_dfa_warm_caches (int  heat)
+{
+  int  res = slre_dfa_benchmark_body (heat);
+
+  return;
+}
+
+
+void
+slre_dfa_benchmark (void)
+{
+  for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
+  {
+    slre_dfa_executions++;
+    /* Execute once and check if different of correct */
+    if(slre_dfa_verify_benchmark(slre_dfa_benchmark_body(1)) != 1)
+    {
+      slre_dfa_errors++;
+      log_error_event("slre-dfa", slre_dfa_errors, slre_dfa_executions, " pair=%d", dfa_first_bad, 0);
+    }
+  }
+}
+
+
+/* Returns the number of pattern/text pairs that differ from slre_match () */
+
+static int __attribute__ ((noinline))
+slre_dfa_benchmark_body (int rpt)
+{
+  int bad = 0;
+  int j;
+
+  for (j = 0; j < rpt; j++)
+    {
+      int p, t;
+
+      bad = 0;
+      dfa_first_bad = -1;
+
+      for (p = 0; p < SLRE_DFA_PATTERNS; p++)
+	for (t = 0; t < SLRE_DFA_TEXTS; t++)
+	  {
+	    int k = p * SLRE_DFA_TEXTS + t;
+
+	    if (slre_dfa_match (&dfa_compiled[p], dfa_texts[t],
+				dfa_text_len[t]) != dfa_golden[k])
+	      {
+		if (0 == bad++)
+		  dfa_first_bad = k;
+	      }
+	  }
+    }
+
+  return bad;
+}
+
+
+int
+slre_dfa_verify_benchmark (int r)
+{
+  return 0 == r && 0 == dfa_init_errors;
+}
+
+unsigned int
+slre_dfa_get_errors (void)
+{
+  return slre_dfa_errors;
+}
+
+unsigned int
+slre_dfa_get_executions (void)
+{
+  return slre_dfa_executions;
+}
+
+
 /*
    Local Variables:
    mode: C
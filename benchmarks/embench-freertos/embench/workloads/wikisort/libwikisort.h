@@ -42,6 +42,20 @@ int wikisort_verify_benchmark(int res);
 unsigned int wikisort_get_errors(void);
 unsigned int wikisort_get_executions(void);
 
+/* Partitioned variant with WIKISORT_PAR_SIZE items */
+void wikisort_par_initialise_benchmark(void);
+void wikisort_par_warm_caches(int temperature);
+void wikisort_par_benchmark(void) __attribute__ ((noinline));
+int wikisort_par_verify_benchmark(int res);
+unsigned int wikisort_par_get_errors(void);
+unsigned int wikisort_par_get_executions(void);
+
+/* Independent units of work, for splitting the sort over harts: all the
+   partitions must be sorted before round 0, and all the slices of a round
+   merged before the next one */
+void wikisort_par_sort_part(long part);
+void wikisort_par_merge_slice(int round, long slice);
+
 /* Local simplified versions of library functions */
 
 #endif /* LIBWIKISORT_H */
@@ -52,7 +52,7 @@
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                    ( 7 )
 #define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 256 )
-#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 50 * 1024 ) )
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 80 * 1024 ) )
 #define configMAX_TASK_NAME_LEN                 ( 16 )
 #define configUSE_TRACE_FACILITY                0
 #define configUSE_16_BIT_TICKS                  0
@@ -0,0 +1,210 @@
+#include <string.h>
+
+#include "inc/hwerr.h"
+
+#if defined(__linux__)
+#include <stdio.h>
+#include <dirent.h>
+
+#ifndef HWERR_EDAC_ROOT
+#define HWERR_EDAC_ROOT         "/sys/devices/system/edac"
+#endif
+
+static char hwerr_edac_path[HWERR_SOURCES][160];
+static char hwerr_edac_name[HWERR_SOURCES][48];
+static uint32_t hwerr_edac_last[HWERR_SOURCES][2];
+static uint8_t hwerr_edac_count;
+
+static uint8_t hwerr_edac_read(const char *dir, const char *file, uint32_t *value)
+{
+    char path[192];
+    FILE *f;
+    uint8_t ok;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+    f = fopen(path, "r");
+    if (f == NULL)
+    {
+        return 0;
+    }
+    ok = (fscanf(f, "%u", value) == 1);
+    fclose(f);
+    return ok;
+}
+
+/* Sources are the directories with both counters, up to two levels down (mc/mc0,
+ * an edac_device and its instances) */
+static void hwerr_edac_scan(const char *dir, const char *name, uint8_t depth)
+{
+    DIR *d;
+    struct dirent *entry;
+    uint32_t ce, ue;
+
+    if ((depth > 0) && hwerr_edac_read(dir, "ce_count", &ce) && hwerr_edac_read(dir, "ue_count", &ue) &&
+        (hwerr_edac_count < HWERR_SOURCES))
+    {
+        snprintf(hwerr_edac_path[hwerr_edac_count], sizeof(hwerr_edac_path[0]), "%s", dir);
+        snprintf(hwerr_edac_name[hwerr_edac_count], sizeof(hwerr_edac_name[0]), "%s", name);
+        hwerr_edac_count++;
+    }
+    if ((depth == 2) || ((d = opendir(dir)) == NULL))
+    {
+        return;
+    }
+    while ((entry = readdir(d)) != NULL)
+    {
+        char path[160], sub[48];
+
+        if ((entry->d_type != DT_DIR) || (entry->d_name[0] == '.'))
+        {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        snprintf(sub, sizeof(sub), "%s%s%s", name, (depth > 0) ? "/" : "", entry->d_name);
+        hwerr_edac_scan(path, sub, depth + 1);
+    }
+    closedir(d);
+}
+
+void hwerr_init(void)
+{
+    hwerr_edac_count = 0;
+    memset(hwerr_edac_last, 0, sizeof(hwerr_edac_last));
+    hwerr_edac_scan(HWERR_EDAC_ROOT, "", 0);
+}
+
+uint8_t hwerr_collect(hwerr_delta_t *delta, uint8_t max)
+{
+    uint8_t n = 0;
+    uint32_t ce, ue;
+
+    for (uint8_t i = 0; (i < hwerr_edac_count) && (n < max); i++)
+    {
+        if (!hwerr_edac_read(hwerr_edac_path[i], "ce_count", &ce) || !hwerr_edac_read(hwerr_edac_path[i], "ue_count", &ue) ||
+            ((ce == hwerr_edac_last[i][0]) && (ue == hwerr_edac_last[i][1])))
+        {
+            continue;
+        }
+        delta[n].name = hwerr_edac_name[i];
+        delta[n].corrected = ce - hwerr_edac_last[i][0];
+        delta[n].uncorrected = ue - hwerr_edac_last[i][1];
+        delta[n].cause = 0;
+        delta[n].addr = 0;
+        hwerr_edac_last[i][0] = ce;
+        hwerr_edac_last[i][1] = ue;
+        n++;
+    }
+    return n;
+}
+
+#else
+
+#include "mpfs_hal/mss_hal.h"
+
+#define HWERR_REG32(addr)           (*(volatile uint32_t *)(uintptr_t)(addr))
+#define HWERR_REG64(addr)           (*(volatile uint64_t *)(uintptr_t)(addr))
+
+/* L2 cache controller: ECC fix/fail address (64-bit, read as two words) and count */
+#define HWERR_L2_BASE               0x02010000UL
+
+/* Bus error units, one per hart */
+#define HWERR_BEU_BASE(hart)        (0x01700000UL + ((hart) * 0x1000UL))
+#define HWERR_BEU_CAUSE             0x00
+#define HWERR_BEU_VALUE             0x08
+#define HWERR_BEU_ENABLE            0x10
+#define HWERR_BEU_ACCRUED           0x20
+#define HWERR_BEU_HARTS             5
+
+#define HWERR_BEU_CORRECTABLE       ((1 << HWERR_BEU_ICACHE_CE) | (1 << HWERR_BEU_DCACHE_CE))
+#define HWERR_BEU_UNCORRECTABLE     ((1 << HWERR_BEU_ITIM_UE) | (1 << HWERR_BEU_DCACHE_UE))
+#define HWERR_BEU_EVENTS            (HWERR_BEU_CORRECTABLE | HWERR_BEU_UNCORRECTABLE | (1 << HWERR_BEU_TILELINK))
+
+typedef struct
+{
+    const char *name;
+    uint16_t fix_addr;                  /* offsets from HWERR_L2_BASE */
+    uint16_t fix_count;
+    uint16_t fail_addr;
+    uint16_t fail_count;
+} hwerr_l2_t;
+
+static const hwerr_l2_t hwerr_l2[2] =
+{
+    {"l2_dir",  0x100, 0x108, 0x120, 0x128},
+    {"l2_data", 0x140, 0x148, 0x160, 0x168},
+};
+static const char *hwerr_beu_name[HWERR_BEU_HARTS] = {"beu_h0", "beu_h1", "beu_h2", "beu_h3", "beu_h4"};
+static uint32_t hwerr_l2_last[2][2];
+static uint64_t hwerr_beu_last[HWERR_BEU_HARTS][2];  /* cause, accrued as last seen */
+
+static uint64_t hwerr_l2_addr(uint16_t offset)
+{
+    return HWERR_REG32(HWERR_L2_BASE + offset) | ((uint64_t)HWERR_REG32(HWERR_L2_BASE + offset + 4) << 32);
+}
+
+/* Enables the BEU event types above to be latched and accrued, on the calling hart only:
+ * the other units belong to their harts (HART0 handles its own as [ERROR]) */
+void hwerr_init(void)
+{
+    HWERR_REG64(HWERR_BEU_BASE(read_csr(mhartid)) + HWERR_BEU_ENABLE) |= HWERR_BEU_EVENTS;
+}
+
+uint8_t hwerr_collect(hwerr_delta_t *delta, uint8_t max)
+{
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; (i < 2) && (n < max); i++)
+    {
+        uint32_t fix = HWERR_REG32(HWERR_L2_BASE + hwerr_l2[i].fix_count);
+        uint32_t fail = HWERR_REG32(HWERR_L2_BASE + hwerr_l2[i].fail_count);
+
+        if ((fix == hwerr_l2_last[i][0]) && (fail == hwerr_l2_last[i][1]))
+        {
+            continue;
+        }
+        delta[n].name = hwerr_l2[i].name;
+        delta[n].corrected = fix - hwerr_l2_last[i][0];
+        delta[n].uncorrected = fail - hwerr_l2_last[i][1];
+        delta[n].cause = 0;
+        delta[n].addr = hwerr_l2_addr((fail != hwerr_l2_last[i][1]) ? hwerr_l2[i].fail_addr : hwerr_l2[i].fix_addr);
+        hwerr_l2_last[i][0] = fix;
+        hwerr_l2_last[i][1] = fail;
+        n++;
+    }
+
+    for (uint8_t hart = 0; (hart < HWERR_BEU_HARTS) && (n < max); hart++)
+    {
+        uintptr_t beu = HWERR_BEU_BASE(hart);
+        uint64_t cause = HWERR_REG64(beu + HWERR_BEU_CAUSE);
+        uint64_t accrued = HWERR_REG64(beu + HWERR_BEU_ACCRUED);
+        uint64_t raised = accrued & ~hwerr_beu_last[hart][1];
+
+        /* Nothing new, or only cleared by its own hart */
+        if ((raised == 0) && ((cause == hwerr_beu_last[hart][0]) || (cause == 0)))
+        {
+            hwerr_beu_last[hart][0] = cause;
+            hwerr_beu_last[hart][1] = accrued;
+            continue;
+        }
+        delta[n].name = hwerr_beu_name[hart];
+        delta[n].corrected = __builtin_popcountll(raised & HWERR_BEU_CORRECTABLE);
+        delta[n].uncorrected = __builtin_popcountll(raised & HWERR_BEU_UNCORRECTABLE);
+        delta[n].cause = (uint32_t)cause;
+        delta[n].addr = HWERR_REG64(beu + HWERR_BEU_VALUE);
+        n++;
+
+        if (hart == read_csr(mhartid))
+        {
+            /* Re-arm our own unit: the cause stays latched until it is cleared */
+            HWERR_REG64(beu + HWERR_BEU_ACCRUED) = 0;
+            HWERR_REG64(beu + HWERR_BEU_CAUSE) = 0;
+            cause = 0;
+            accrued = 0;
+        }
+        hwerr_beu_last[hart][0] = cause;
+        hwerr_beu_last[hart][1] = accrued;
+    }
+    return n;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include <string.h>
+
+#include "inc/logbin.h"
+
+/* Records are built in place: every put checks the remaining space, and a record
+ * that did not fit is flagged and dropped by logbin_frame instead of being sent
+ * truncated. Two bytes are always kept free for the CRC.
+ */
+
+static void logbin_put_byte(logbin_record_t *rec, uint8_t byte)
+{
+    if (rec->len < (LOGBIN_RECORD_SIZE - 2))
+    {
+        rec->buf[rec->len++] = byte;
+    }
+    else
+    {
+        rec->overflow = 1;
+    }
+}
+
+void logbin_begin(logbin_record_t *rec, uint8_t type, uint8_t hart)
+{
+    rec->len = 0;
+    rec->overflow = 0;
+    logbin_put_byte(rec, LOGBIN_TAG(type, hart));
+}
+
+/* Unsigned LEB128: 7 bits per byte, least significant group first */
+void logbin_put_uint(logbin_record_t *rec, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        logbin_put_byte(rec, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    logbin_put_byte(rec, (uint8_t)value);
+}
+
+/* Zigzag keeps small negative values (e.g. temperatures) in one byte */
+void logbin_put_int(logbin_record_t *rec, int32_t value)
+{
+    logbin_put_uint(rec, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+void logbin_put_str(logbin_record_t *rec, const char *str)
+{
+    uint32_t len = strlen(str);
+
+    logbin_put_uint(rec, len);
+    for (uint32_t i = 0; i < len; i++)
+    {
+        logbin_put_byte(rec, (uint8_t)str[i]);
+    }
+}
+
+void logbin_put_int64(logbin_record_t *rec, int64_t value)
+{
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+
+    while (zigzag >= 0x80)
+    {
+        logbin_put_byte(rec, (uint8_t)(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    logbin_put_byte(rec, (uint8_t)zigzag);
+}
+
+void logbin_put_double(logbin_record_t *rec, double value)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        logbin_put_byte(rec, (uint8_t)(bits >> (8 * i)));
+    }
+}
+
+void logbin_put_ptr(logbin_record_t *rec, const void *ptr)
+{
+    logbin_put_int64(rec, (int64_t)(uintptr_t)ptr);
+}
+
+/* CRC-16/CCITT-FALSE, bitwise to keep it table-free */
+static uint16_t logbin_crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* CRC-32 (IEEE, as zlib.crc32) of words sent little-endian. Chained like zlib: pass 0
+ * first, then the previous result. Used for the results state of delta reports. */
+uint32_t logbin_crc32(uint32_t crc, const uint32_t *words, uint32_t count)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint8_t byte = 0; byte < 4; byte++)
+        {
+            crc ^= (uint8_t)(words[i] >> (8 * byte));
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+            }
+        }
+    }
+
+    return ~crc;
+}
+
+/* Appends the CRC and writes the line to wire (at least LOGBIN_WIRE_SIZE bytes).
+ * Returns the number of bytes to send, or 0 if the record overflowed.
+ */
+uint16_t logbin_frame(logbin_record_t *rec, uint8_t *wire)
+{
+    uint16_t crc;
+    uint16_t out = 0;
+    uint16_t code_at;
+    uint8_t code = 1;
+
+    if (rec->overflow)
+    {
+        return 0;
+    }
+
+    crc = logbin_crc16(rec->buf, rec->len);
+    rec->buf[rec->len++] = (uint8_t)(crc >> 8);
+    rec->buf[rec->len++] = (uint8_t)crc;
+
+    wire[out++] = 0x00;
+
+    /* COBS: each block starts with the distance to the next zero (or 0xFF for
+     * a full 254-byte run without one) */
+    code_at = out++;
+    for (uint16_t i = 0; i < rec->len; i++)
+    {
+        if (rec->buf[i] == 0)
+        {
+            wire[code_at] = code ^ 0x0A;
+            code_at = out++;
+            code = 1;
+        }
+        else
+        {
+            wire[out++] = rec->buf[i] ^ 0x0A;
+            if (++code == 0xFF)
+            {
+                wire[code_at] = code ^ 0x0A;
+                code_at = out++;
+                code = 1;
+            }
+        }
+    }
+    wire[code_at] = code ^ 0x0A;
+
+    wire[out++] = 0x0A;
+
+    return out;
+}
@@ -0,0 +1,103 @@
+#include <string.h>
+
+#include "inc/logtx.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+/* Port: 1 when the part given last has gone out */
+static uint8_t logtx_port_idle(logtx_port_t port)
+{
+#if defined(__linux__)
+    (void)port;
+    return 1;
+#else
+    return (MSS_UART_tx_complete(port) != 0);
+#endif
+}
+
+/* Port: starts sending len bytes, returns how many it took (the MMUART takes them
+ * all and reads them from the ring until it is idle again, write() copies them) */
+static uint32_t logtx_port_start(logtx_port_t port, const uint8_t *data, uint32_t len)
+{
+#if defined(__linux__)
+    ssize_t n = write(port, data, len);
+
+    return (n > 0) ? (uint32_t)n : 0;
+#else
+    MSS_UART_irq_tx(port, data, len);
+    return len;
+#endif
+}
+
+void logtx_poll(logtx_queue_t *queue, logtx_port_t port)
+{
+    uint32_t offset, chunk;
+
+    if (queue->inflight != queue->sent)
+    {
+        if (!logtx_port_idle(port))
+        {
+            return;
+        }
+        queue->sent = queue->inflight;
+
+        while ((queue->pending_tail != queue->pending_head) &&
+               ((int32_t)(queue->sent - queue->pending[queue->pending_tail % LOGTX_PENDING].end) >= 0))
+        {
+            logtx_pending_t *pending = &queue->pending[queue->pending_tail % LOGTX_PENDING];
+
+            queue->pending_tail++;
+            pending->done(pending->arg);
+        }
+    }
+
+    if (queue->head != queue->sent)
+    {
+        /* Up to the end of the ring, the rest goes with the next poll */
+        offset = queue->sent & (LOGTX_RING_SIZE - 1);
+        chunk = queue->head - queue->sent;
+        chunk = (chunk < (LOGTX_RING_SIZE - offset)) ? chunk : (LOGTX_RING_SIZE - offset);
+        queue->inflight = queue->sent + logtx_port_start(port, &queue->data[offset], chunk);
+    }
+}
+
+void logtx_write(logtx_queue_t *queue, logtx_port_t port, const uint8_t *data, uint32_t len, logtx_done_t done, void *arg)
+{
+    uint32_t offset, chunk;
+
+    while (len > 0)
+    {
+        /* Only a full ring makes the writer wait, for the port to free some space */
+        while ((LOGTX_RING_SIZE - (queue->head - queue->sent)) == 0)
+        {
+            logtx_poll(queue, port);
+        }
+
+        offset = queue->head & (LOGTX_RING_SIZE - 1);
+        chunk = LOGTX_RING_SIZE - (queue->head - queue->sent);
+        chunk = (chunk < (LOGTX_RING_SIZE - offset)) ? chunk : (LOGTX_RING_SIZE - offset);
+        chunk = (chunk < len) ? chunk : len;
+
+        memcpy(&queue->data[offset], data, chunk);
+        queue->head += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+
+    if (done != NULL)
+    {
+        while ((queue->pending_head - queue->pending_tail) == LOGTX_PENDING)
+        {
+            logtx_poll(queue, port);
+        }
+        queue->pending[queue->pending_head % LOGTX_PENDING].end = queue->head;
+        queue->pending[queue->pending_head % LOGTX_PENDING].done = done;
+        queue->pending[queue->pending_head % LOGTX_PENDING].arg = arg;
+        queue->pending_head++;
+    }
+
+    logtx_poll(queue, port);
+}
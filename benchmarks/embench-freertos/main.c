@@ -67,7 +67,15 @@ void main(void)
     /* (0x862000 - 0x3e8) * ( 1/150MHz/256) = ~15s after system reset */
     MSS_WD_configure(MSS_WDOG1_LO, &wd1lo_config);
 
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+    logbin_begin(&rec, LOGBIN_LIFECYCLE, read_csr(mhartid));
+    logbin_put_uint(&rec, LOGBIN_MARK_INIT);
+    log_record_from_appcore(hart_share, &rec);
+#else
     log_from_appcore_noheader(hart_share, "\n[INIT_HART1]\n\n");
+#endif
 
 	while(1) 
     {
@@ -91,7 +99,13 @@ void main(void)
             log_from_appcore(hart_share, "Tasks created successfully!\n");
         }
 
+#if (LOG_BINARY == 1)
+        logbin_begin(&rec, LOGBIN_LIFECYCLE, read_csr(mhartid));
+        logbin_put_uint(&rec, LOGBIN_MARK_SCHEDULER);
+        log_record_from_appcore(hart_share, &rec);
+#else
         log_from_appcore(hart_share, "[FREERTOS] Start scheduler \n");
+#endif
         vTaskStartScheduler();
     }
 
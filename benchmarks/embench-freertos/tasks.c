@@ -55,7 +55,7 @@ void run_workload
 	#endif
 }
 
-void print_results(HART_SHARED_DATA *h_shared)
+void print_results(HART_SHARED_DATA *h_shared, uint32_t cycle)
 {
     uint16_t len = 0;
     char buf[LOG_MSG_SIZE];
@@ -70,6 +70,19 @@ void print_results(HART_SHARED_DATA *h_shared)
         vTaskResume(embench_task_handle[i]);
     }
 
+#if (LOG_BINARY == 1)
+    uint32_t errors[WORKLOADS], execs[WORKLOADS], runtime[WORKLOADS];
+
+    for (uint8_t i = 0; i < WORKLOADS; i++)
+    {
+        errors[i] = buffer[i].errors;
+        execs[i] = buffer[i].execs;
+        runtime[i] = buffer[i].runtime;
+    }
+    log_results_from_appcore(h_shared, cycle, WORKLOADS, errors, execs, runtime);
+#else
+    len = sprintf(buf, "[HART%d] [BENCHMARK_END] embench_results: %u\n", hart_id, cycle);
+
     len += sprintf(buf+len, "[HART%d]   num_errors = [ ", hart_id);
 	for (uint8_t i = 0; i < (WORKLOADS-1); i++)
 	{
@@ -92,6 +105,40 @@ void print_results(HART_SHARED_DATA *h_shared)
 	len += sprintf(buf+len, "%u ]\n\n", buffer[WORKLOADS-1].runtime);
 
     log_from_appcore_noheader(h_shared, buf);
+#endif
+}
+
+/* Cycle start marker followed by the TVS reading */
+static void log_cycle_start(HART_SHARED_DATA *h_shared, uint32_t cycle, const char *fmt)
+{
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+    logbin_begin(&rec, LOGBIN_LIFECYCLE, read_csr(mhartid));
+    logbin_put_uint(&rec, LOGBIN_MARK_CYCLE_START);
+    logbin_put_uint(&rec, cycle);
+    log_record_from_appcore(h_shared, &rec);
+#else
+    log_from_appcore(h_shared, fmt, cycle);
+#endif
+
+    /* Print TVS information */
+    log_tvs_from_appcore(h_shared);
+}
+
+/* [FREERTOS] Start of:/End of: markers around each workload run */
+static void log_task_marker(HART_SHARED_DATA *h_shared, uint8_t marker, const char *bench_name)
+{
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+    logbin_begin(&rec, LOGBIN_LIFECYCLE, read_csr(mhartid));
+    logbin_put_uint(&rec, marker);
+    logbin_put_str(&rec, bench_name);
+    log_record_from_appcore(h_shared, &rec);
+#else
+    log_from_appcore(h_shared, "[FREERTOS] %s of: %s\n", (marker == LOGBIN_MARK_TASK_START) ? "Start" : "End", bench_name);
+#endif
 }
 
 int create_tasks(HART_SHARED_DATA *h_shared) 
@@ -114,6 +161,17 @@ int create_tasks(HART_SHARED_DATA *h_shared)
         err = -1;
     }
 
+#if (TVS_SAMPLER == 1)
+    /* TVS sampler, runs in the timer service task, above the housekeeping task */
+    timer_tvs = xTimerCreate("tvs", pdMS_TO_TICKS(TVS_SAMPLE_MS), pdTRUE, NULL, vTimer_TvsSample);
+
+    if ((timer_tvs == NULL) || (xTimerStart(timer_tvs, 0) != pdPASS))
+    {
+        /* Error creating timer */
+        err = -1;
+    }
+#endif
+
     /* Embench tasks */
     for (int i = 0; i < WORKLOADS; i++)
     {
@@ -152,7 +210,7 @@ int create_queues(HART_SHARED_DATA *h_shared)
     {
         embench_queue_handle[i] = xQueueCreate(1, sizeof(queue_message_t));
 
-        log_from_appcore(h_shared, "Queue %d: %p\n", i, embench_queue_handle[i]);
+        log_from_appcore(h_shared, "Queue %d: %p\n", i, (void *)embench_queue_handle[i]);
         
         if (embench_queue_handle[i] == NULL)
         {
@@ -191,58 +249,35 @@ void vTask_Housekeeping(void* pvParameters)
 {
     uint32_t execution_cycle = 0;
 
-    /* Temperature/voltage sensors */
-    uint32_t tvs_out0 = 0, tvs_out1 = 0;
-    uint16_t volt_1v0 = 0, volt_1v8 = 0, volt_2v5 = 0, temperature = 0;  
-    
-    log_from_appcore(pvParameters, "[BENCHMARK_START] run_cycle: %d\n\n", execution_cycle);
-    /* Print TVS information */
-    tvs_out0 = MSS_SCBCTRL->TVS_OUTPUT0;
-    tvs_out1 = MSS_SCBCTRL->TVS_OUTPUT1;
-    volt_1v0 = (tvs_out0 & 0x00007FFF) >> 3; 
-    volt_1v8 = (tvs_out0 & 0x7FFF0000) >> 19;
-    volt_2v5 = (tvs_out1 & 0x00007FFF) >> 3;
-    temperature = ((tvs_out1 & 0x7FFF0000) >> 20) - 273;
-    if ((volt_1v0 != 0) || (volt_1v8 != 0) || (volt_2v5 != 0))  
-    {
-        log_from_appcore(pvParameters, "[TVS] (volt_1v0 = %umV) (volt_1v8 = %umV) (volt_2v5 = %umV) (temp = %uC)\n\n", 
-            volt_1v0, volt_1v8, volt_2v5, temperature);
-    }  
-    else {
-        log_from_appcore(pvParameters, "[TVS] Reading TVS built-in sensor failed\n\n");
-    }
-    
+#if (HWERR_COLLECT == 1)
+    hwerr_init();
+#endif
+    log_cycle_start(pvParameters, execution_cycle, "[BENCHMARK_START] run_cycle: %d\n\n");
+
     while (1) 
     {
         // log_from_appcore(pvParameters, "[FREERTOS] Housekeeping heartbeat\n");
-        
         if (check_queues() == 0)
         {
-            log_from_appcore(pvParameters, "[BENCHMARK_END] embench_results: %d\n", execution_cycle);
-            print_results(pvParameters);
-            log_from_appcore(pvParameters, "[BENCHMARK_START] run_cycle: %d\n", ++execution_cycle);
-
-            /* Print TVS information */
-            tvs_out0 = MSS_SCBCTRL->TVS_OUTPUT0;
-            tvs_out1 = MSS_SCBCTRL->TVS_OUTPUT1;
-            volt_1v0 = (tvs_out0 & 0x00007FFF) >> 3; 
-            volt_1v8 = (tvs_out0 & 0x7FFF0000) >> 19;
-            volt_2v5 = (tvs_out1 & 0x00007FFF) >> 3;
-            temperature = ((tvs_out1 & 0x7FFF0000) >> 20) - 273;
-            if ((volt_1v0 != 0) || (volt_1v8 != 0) || (volt_2v5 != 0))  
-            {
-                log_from_appcore(pvParameters, "[TVS] (volt_1v0 = %umV) (volt_1v8 = %umV) (volt_2v5 = %umV) (temp = %uC)\n\n", 
-                    volt_1v0, volt_1v8, volt_2v5, temperature);
-            }  
-            else {
-                log_from_appcore(pvParameters, "[TVS] Reading TVS built-in sensor failed\n\n");
-            }
-        }
+#if (HWERR_COLLECT == 1)
+            /* L2 ECC and BEU errors of the cycle */
+            log_hwerr_from_appcore(pvParameters);
+#endif
+            print_results(pvParameters, execution_cycle);
 
+            log_cycle_start(pvParameters, ++execution_cycle, "[BENCHMARK_START] run_cycle: %d\n");
+        }
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
 
+/* TVS sampler, every TVS_SAMPLE_MS */
+void vTimer_TvsSample(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+    tvs_sample();
+}
+
 /* aha-mont64 task */
 void vTask_mont64(void* pvParameters) 
 {
@@ -251,7 +286,7 @@ void vTask_mont64(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: aha-mont64\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "aha-mont64");
 
         queue_message_t buffer;
 
@@ -264,7 +299,7 @@ void vTask_mont64(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: aha-mont64\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "aha-mont64");
         
         vTaskSuspend(NULL);
     }
@@ -278,7 +313,7 @@ void vTask_crc32(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: crc32\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "crc32");
 
         queue_message_t buffer;
 
@@ -291,7 +326,7 @@ void vTask_crc32(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: crc32\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "crc32");
         
         vTaskSuspend(NULL);
     }
@@ -305,7 +340,7 @@ void vTask_cubic(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: cubic\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "cubic");
 
         queue_message_t buffer;
 
@@ -318,7 +353,7 @@ void vTask_cubic(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: cubic\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "cubic");
         
         vTaskSuspend(NULL);
     }
@@ -332,7 +367,7 @@ void vTask_edn(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: edn\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "edn");
 
         queue_message_t buffer;
 
@@ -345,7 +380,34 @@ void vTask_edn(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: edn\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "edn");
+        
+        vTaskSuspend(NULL);
+    }
+}
+
+/* huffbench task */
+void vTask_huffbench(void* pvParameters) 
+{
+	workload_task_parameters_t *parameters = pvParameters;
+
+    QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
+    while (1) 
+    {
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "huffbench");
+
+        queue_message_t buffer;
+
+        run_workload(
+            "huffbench",
+            &huffbench_initialise_benchmark, &huffbench_warm_caches, &huffbench_benchmark, &huffbench_verify_benchmark, 
+            &huffbench_get_errors, &huffbench_get_executions, parameters->h_shared, &buffer
+        );
+        
+        xQueueSend(result_queue, (void *)&buffer, 0);
+
+        MSS_WD_reload(parameters->wdt);
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "huffbench");
         
         vTaskSuspend(NULL);
     }
@@ -359,7 +421,7 @@ void vTask_matmult(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: matmult\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "matmult");
 
         queue_message_t buffer;
 
@@ -372,7 +434,7 @@ void vTask_matmult(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: matmult\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "matmult");
         
         vTaskSuspend(NULL);
     }
@@ -386,7 +448,7 @@ void vTask_matmult(void* pvParameters)
 //     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
 //     while (1) 
 //     {
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: minver\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "minver");
 
 //         queue_message_t buffer;
 
@@ -399,7 +461,7 @@ void vTask_matmult(void* pvParameters)
 //         xQueueSend(result_queue, (void *)&buffer, 0);
 
 //         MSS_WD_reload(parameters->wdt);
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] End of: minver\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "minver");
         
 //         vTaskSuspend(NULL);
 //     }
@@ -415,7 +477,7 @@ void vTask_nbody(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: nbody\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "nbody");
 
         queue_message_t buffer;
 
@@ -428,7 +490,7 @@ void vTask_nbody(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: nbody\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "nbody");
         
         vTaskSuspend(NULL);
     }
@@ -442,7 +504,7 @@ void vTask_aes(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: aes\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "aes");
 
         queue_message_t buffer;
 
@@ -455,7 +517,7 @@ void vTask_aes(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: aes\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "aes");
         
         vTaskSuspend(NULL);
     }
@@ -469,7 +531,7 @@ void vTask_sha256(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: sha256\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "sha256");
 
         queue_message_t buffer;
 
@@ -482,7 +544,7 @@ void vTask_sha256(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: sha256\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "sha256");
         
         vTaskSuspend(NULL);
     }
@@ -497,7 +559,7 @@ void vTask_nsichneu(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: nsichneu\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "nsichneu");
 
         queue_message_t buffer;
 
@@ -510,7 +572,91 @@ void vTask_nsichneu(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: nsichneu\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "nsichneu");
+        
+        vTaskSuspend(NULL);
+    }
+}
+
+
+/* nsichneu-bits task */
+void vTask_nsibits(void* pvParameters) 
+{
+	workload_task_parameters_t *parameters = pvParameters;
+
+    QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
+    while (1) 
+    {
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "nsichneu-bits");
+
+        queue_message_t buffer;
+
+        run_workload(
+            "nsichneu-bits",
+            &nsichneu_bits_initialise_benchmark, &nsichneu_bits_warm_caches, &nsichneu_bits_benchmark, &nsichneu_bits_verify_benchmark, 
+            &nsichneu_bits_get_errors, &nsichneu_bits_get_executions, parameters->h_shared, &buffer
+        );
+        
+        xQueueSend(result_queue, (void *)&buffer, 0);
+
+        MSS_WD_reload(parameters->wdt);
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "nsichneu-bits");
+        
+        vTaskSuspend(NULL);
+    }
+}
+
+
+/* qrduino-lite task */
+void vTask_qrlite(void* pvParameters) 
+{
+	workload_task_parameters_t *parameters = pvParameters;
+
+    QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
+    while (1) 
+    {
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "qrduino-lite");
+
+        queue_message_t buffer;
+
+        run_workload(
+            "qrduino-lite",
+            &qrduino_lite_initialise_benchmark, &qrduino_lite_warm_caches, &qrduino_lite_benchmark, &qrduino_lite_verify_benchmark, 
+            &qrduino_lite_get_errors, &qrduino_lite_get_executions, parameters->h_shared, &buffer
+        );
+        
+        xQueueSend(result_queue, (void *)&buffer, 0);
+
+        MSS_WD_reload(parameters->wdt);
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "qrduino-lite");
+        
+        vTaskSuspend(NULL);
+    }
+}
+
+
+/* sglib-combined task */
+void vTask_sglib(void* pvParameters) 
+{
+	workload_task_parameters_t *parameters = pvParameters;
+
+    QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
+    while (1) 
+    {
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "sglib-combined");
+
+        queue_message_t buffer;
+
+        run_workload(
+            "sglib-combined",
+            &sglib_initialise_benchmark, &sglib_warm_caches, &sglib_benchmark, &sglib_verify_benchmark, 
+            &sglib_get_errors, &sglib_get_executions, parameters->h_shared, &buffer
+        );
+        
+        xQueueSend(result_queue, (void *)&buffer, 0);
+
+        MSS_WD_reload(parameters->wdt);
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "sglib-combined");
         
         vTaskSuspend(NULL);
     }
@@ -526,7 +672,7 @@ void vTask_nsichneu(void* pvParameters)
 //     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
 //     while (1) 
 //     {
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: slre\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "slre");
 
 //         queue_message_t buffer;
 
@@ -539,7 +685,7 @@ void vTask_nsichneu(void* pvParameters)
 //         xQueueSend(result_queue, (void *)&buffer, 0);
 
 //         MSS_WD_reload(parameters->wdt);
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] End of: slre\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "slre");
         
 //         vTaskSuspend(NULL);
 //     }
@@ -554,7 +700,7 @@ void vTask_nsichneu(void* pvParameters)
 //     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
 //     while (1) 
 //     {
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: st\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "st");
 
 //         queue_message_t buffer;
 
@@ -567,7 +713,7 @@ void vTask_nsichneu(void* pvParameters)
 //         xQueueSend(result_queue, (void *)&buffer, 0);
 
 //         MSS_WD_reload(parameters->wdt);
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] End of: st\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "st");
         
 //         vTaskSuspend(NULL);
 //     }
@@ -581,7 +727,7 @@ void vTask_statemate(void* pvParameters)
     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
     while (1) 
     {
-        log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: statemate\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "statemate");
 
         queue_message_t buffer;
 
@@ -594,7 +740,7 @@ void vTask_statemate(void* pvParameters)
         xQueueSend(result_queue, (void *)&buffer, 0);
 
         MSS_WD_reload(parameters->wdt);
-        log_from_appcore(parameters->h_shared, "[FREERTOS] End of: statemate\n");
+        log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "statemate");
         
         vTaskSuspend(NULL);
     }
@@ -609,7 +755,7 @@ void vTask_statemate(void* pvParameters)
 //     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
 //     while (1) 
 //     {
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: ud\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "ud");
 
 //         queue_message_t buffer;
 
@@ -622,7 +768,7 @@ void vTask_statemate(void* pvParameters)
 //         xQueueSend(result_queue, (void *)&buffer, 0);
 
 //         MSS_WD_reload(parameters->wdt);
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] End of: ud\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "ud");
         
 //         vTaskSuspend(NULL);
 //     }
@@ -637,7 +783,7 @@ void vTask_statemate(void* pvParameters)
 //     QueueHandle_t result_queue = (QueueHandle_t) parameters->queue_handle;
 //     while (1) 
 //     {
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] Start of: wikisort\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_START, "wikisort");
 
 //         queue_message_t buffer;
 
@@ -650,7 +796,7 @@ void vTask_statemate(void* pvParameters)
 //         xQueueSend(result_queue, (void *)&buffer, 0);
 
 //         MSS_WD_reload(parameters->wdt);
-//         log_from_appcore(parameters->h_shared, "[FREERTOS] End of: wikisort\n");
+//         log_task_marker(parameters->h_shared, LOGBIN_MARK_TASK_END, "wikisort");
         
 //         vTaskSuspend(NULL);
 //     }
@@ -15,6 +15,7 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include <queue.h>
+#include <timers.h>
 
 #include "common.h"
 
@@ -22,16 +23,18 @@
 #define ENABLE_WORKLOAD_CRC32           1  /* CRC error checking 32b                                                            */
 #define ENABLE_WORKLOAD_CUBIC           1  /* Cubic root solver                                                                 */
 #define ENABLE_WORKLOAD_EDN             1  /* More general filter                                                               */
-#define ENABLE_WORKLOAD_HUFFBENCH       0  /* Compress/decompress              - OFF due to unsafe dynamic memory allocation    */
+#define ENABLE_WORKLOAD_HUFFBENCH       1  /* Compress/decompress                                                               */
 #define ENABLE_WORKLOAD_MATMULT         1  /* Integer matrix multiply                                                           */
 #define ENABLE_WORKLOAD_MINVER          0  /* Matrix inversion                                                                  */
 #define ENABLE_WORKLOAD_NBODY           0  /* Satellite N body, large data                                                      */
 #define ENABLE_WORKLOAD_NETTLE_AES      0  /* Encrypt/decrypt                                                                   */
 #define ENABLE_WORKLOAD_NETTLE_SHA256   0  /* Crytographic hash                                                                 */
 #define ENABLE_WORKLOAD_NSICHNEU        0  /* Large - Petri net                                                                 */
+#define ENABLE_WORKLOAD_NSICHNEU_BITS   1  /* Petri net from a transition table - variant of NSICHNEU, bit-parallel guards      */
 #define ENABLE_WORKLOAD_PICOJPEG        0  /* JPEG                             - OFF due to memory space limitation and scope   */
 #define ENABLE_WORKLOAD_QRDUINO         0  /* QR codes                         - OFF due to memory space limitation and scope   */
-#define ENABLE_WORKLOAD_SGLIB_COMBINED  0  /* Simple Generic Library for C     - OFF due to unsafe dynamic memory allocation    */
+#define ENABLE_WORKLOAD_QRDUINO_LITE    1  /* QR codes in a fixed 1.8 KB frame - variant of QRDUINO, no heap, rotating payloads */
+#define ENABLE_WORKLOAD_SGLIB_COMBINED  1  /* Simple Generic Library for C                                                      */
 #define ENABLE_WORKLOAD_SLRE            0  /* Regex                            - OFF due to eNVM limitation with FreeRTOS       */
 #define ENABLE_WORKLOAD_ST              0  /* Statistics                       - OFF due to eNVM limitation with FreeRTOS       */
 #define ENABLE_WORKLOAD_STATEMATE       0  /* State machine (car window)                                                        */
@@ -41,7 +44,7 @@
 #define WORKLOADS   \
     (ENABLE_WORKLOAD_AHA_MONT64 + ENABLE_WORKLOAD_CRC32 + ENABLE_WORKLOAD_CUBIC + ENABLE_WORKLOAD_EDN + ENABLE_WORKLOAD_HUFFBENCH + \
     ENABLE_WORKLOAD_MATMULT + ENABLE_WORKLOAD_MINVER + ENABLE_WORKLOAD_NBODY + ENABLE_WORKLOAD_NETTLE_AES + ENABLE_WORKLOAD_NETTLE_SHA256 + \
-    ENABLE_WORKLOAD_NSICHNEU + ENABLE_WORKLOAD_PICOJPEG + ENABLE_WORKLOAD_QRDUINO + ENABLE_WORKLOAD_SGLIB_COMBINED + ENABLE_WORKLOAD_SLRE + \
+    ENABLE_WORKLOAD_NSICHNEU + ENABLE_WORKLOAD_NSICHNEU_BITS + ENABLE_WORKLOAD_PICOJPEG + ENABLE_WORKLOAD_QRDUINO + ENABLE_WORKLOAD_QRDUINO_LITE + ENABLE_WORKLOAD_SGLIB_COMBINED + ENABLE_WORKLOAD_SLRE + \
     ENABLE_WORKLOAD_ST + ENABLE_WORKLOAD_STATEMATE + ENABLE_WORKLOAD_UD + ENABLE_WORKLOAD_WIKISORT)
 
 /* Task definitions */
@@ -50,7 +53,8 @@
 #define HOUSEKEEPING_TASK_STACK_SIZE    2*configMINIMAL_STACK_SIZE
 #define HOUSEKEEPING_TASK_PRIORITY      2
 
-static uint16_t embench_tasks_stack[WORKLOADS] = {512,512,512,512,512};
+/* huffbench keeps ~13 KB of tables on the stack, sglib recurses in the rbtree */
+static uint16_t embench_tasks_stack[WORKLOADS] = {512,512,512,512,2048,512,512,512,1024};
 
 /* Struct */
 typedef struct
@@ -71,7 +75,7 @@ typedef struct
 int create_tasks(HART_SHARED_DATA *h_shared);
 int create_queues(HART_SHARED_DATA *h_shared);
 int check_queues(void);
-void print_results(HART_SHARED_DATA *h_shared);
+void print_results(HART_SHARED_DATA *h_shared, uint32_t cycle);
 
 void run_workload(char *bench_name, void (*initialise_benchmark)(void),
 	void (*warm_caches)(int), void (*benchmark)(void), int (*verify_benchmark)(int),    
@@ -80,16 +84,21 @@ void run_workload(char *bench_name, void (*initialise_benchmark)(void),
 
 /* Task prototypes */
 void vTask_Housekeeping(void* pvParameters);
+void vTimer_TvsSample(TimerHandle_t xTimer);
 void vTask_mont64(void* pvParameters);
 void vTask_crc32(void* pvParameters);
 void vTask_cubic(void* pvParameters);
 void vTask_edn(void* pvParameters);
+void vTask_huffbench(void* pvParameters);
 void vTask_matmult(void* pvParameters);
 // void vTask_minver(void* pvParameters);
 void vTask_nbody(void* pvParameters);
 // void vTask_aes(void* pvParameters);
 // void vTask_sha256(void* pvParameters);
 // void vTask_nsichneu(void* pvParameters);
+void vTask_nsibits(void* pvParameters);
+void vTask_qrlite(void* pvParameters);
+void vTask_sglib(void* pvParameters);
 // void vTask_statemate(void* pvParameters);
 
 /* Global variables */
@@ -99,19 +108,22 @@ static QueueHandle_t embench_queue_handle[WORKLOADS] = {NULL};
 static workload_task_parameters_t task_parameters[WORKLOADS];
 
 static void* embench_task_implementation[WORKLOADS] = {
-    vTask_mont64, vTask_crc32, vTask_cubic, vTask_edn, vTask_matmult, vTask_nbody//, vTask_aes, 
+    vTask_mont64, vTask_crc32, vTask_cubic, vTask_edn, vTask_huffbench, vTask_matmult, vTask_nsibits, vTask_qrlite, vTask_sglib, vTask_nbody//, vTask_aes, 
     //vTask_sha256, vTask_statemate
 };
 
 /* Task handles */
 static xTaskHandle task_housekeeping;
+
+/* TVS sampler (TVS_SAMPLER) */
+static TimerHandle_t timer_tvs;
         
 static xTaskHandle embench_task_handle[WORKLOADS] = {NULL};
 
 /* Task names */
 static char embench_task_name[WORKLOADS][10] =
 {
-    "mont64", "crc32", "cubic", "edn", "matmult", "nbody"//, "aes", "sha256", "statemate"
+    "mont64", "crc32", "cubic", "edn", "huffbench", "matmult", "nsibits", "qrlite", "sglib", "nbody"//, "aes", "sha256", "statemate"
 };
 
 
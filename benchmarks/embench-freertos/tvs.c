@@ -0,0 +1,83 @@
+#include <string.h>
+
+#include "mpfs_hal/mss_hal.h"
+#include "inc/tvs.h"
+
+static const int32_t tvs_limit_min[TVS_CHANNELS] = {TVS_1V0_MIN, TVS_1V8_MIN, TVS_2V5_MIN, TVS_TEMP_MIN};
+static const int32_t tvs_limit_max[TVS_CHANNELS] = {TVS_1V0_MAX, TVS_1V8_MAX, TVS_2V5_MAX, TVS_TEMP_MAX};
+
+static tvs_stats_t tvs_stats[2];
+static volatile uint8_t tvs_active;
+static uint8_t tvs_outside;             /* channels outside their limits at the last reading */
+
+/* Reads the sensor, returns 0 if the read failed (all voltages zero) */
+uint8_t tvs_read(int32_t value[TVS_CHANNELS])
+{
+    uint32_t tvs_out0 = MSS_SCBCTRL->TVS_OUTPUT0;
+    uint32_t tvs_out1 = MSS_SCBCTRL->TVS_OUTPUT1;
+
+    value[TVS_1V0] = (tvs_out0 & 0x00007FFF) >> 3;
+    value[TVS_1V8] = (tvs_out0 & 0x7FFF0000) >> 19;
+    value[TVS_2V5] = (tvs_out1 & 0x00007FFF) >> 3;
+    value[TVS_TEMP] = (int32_t)((tvs_out1 & 0x7FFF0000) >> 20) - 273;
+
+    return (value[TVS_1V0] != 0) || (value[TVS_1V8] != 0) || (value[TVS_2V5] != 0);
+}
+
+void tvs_sample(void)
+{
+    tvs_stats_t *stats = &tvs_stats[tvs_active];
+    int32_t value[TVS_CHANNELS];
+
+    if (!tvs_read(value))
+    {
+        stats->failed++;
+        return;
+    }
+
+    for (uint8_t i = 0; i < TVS_CHANNELS; i++)
+    {
+        if ((stats->samples == 0) || (value[i] < stats->min[i]))
+        {
+            stats->min[i] = value[i];
+        }
+        if ((stats->samples == 0) || (value[i] > stats->max[i]))
+        {
+            stats->max[i] = value[i];
+        }
+        stats->sum[i] += value[i];
+
+        /* A crossing is counted when a channel leaves its limits, not for every reading outside */
+        if ((value[i] < tvs_limit_min[i]) || (value[i] > tvs_limit_max[i]))
+        {
+            if (!(tvs_outside & (1 << i)))
+            {
+                if (stats->crossings == 0)
+                {
+                    stats->first_channel = i;
+                    stats->first_value = value[i];
+                    stats->first_stamp = read_csr(mcycle);
+                }
+                stats->crossings++;
+                tvs_outside |= (1 << i);
+            }
+        }
+        else
+        {
+            tvs_outside &= ~(1 << i);
+        }
+    }
+    stats->samples++;
+}
+
+/* Closes the interval: later readings go to the other buffer (see tvs.h) */
+void tvs_take(tvs_stats_t *stats)
+{
+    uint8_t done = tvs_active;
+
+    tvs_active = done ^ 1;
+    __sync_synchronize();
+
+    memcpy(stats, &tvs_stats[done], sizeof(tvs_stats_t));
+    memset(&tvs_stats[done], 0, sizeof(tvs_stats_t));
+}
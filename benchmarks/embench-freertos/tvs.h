@@ -0,0 +1,60 @@
+/*******************************************************************************
+ *
+ * Periodic TVS (temperature and voltage sensor) sampling (TVS_SAMPLER == 1)
+ *
+ * tvs_sample() is called from a timer at TVS_SAMPLE_MS: it reads the sensor and
+ * folds the reading into the statistics of the current reporting interval, so a
+ * short droop shows up in the min/max even if it is over before the next report.
+ * A reading that leaves its limits counts as a crossing, the first crossing of
+ * the interval keeps its channel, value and mcycle.
+ *
+ * tvs_take() closes the interval and hands its statistics to the reporter. The
+ * statistics are double buffered: the sampler must run on the same hart as the
+ * reporter and must not be preempted by it (timer interrupt, or a higher priority
+ * task such as the FreeRTOS timer service).
+ *
+ */
+
+#ifndef TVS_H_
+#define TVS_H_
+
+#include <stdint.h>
+
+/* Channels, in the order of the [TVS] line */
+#define TVS_1V0                 0   /* mV */
+#define TVS_1V8                 1   /* mV */
+#define TVS_2V5                 2   /* mV */
+#define TVS_TEMP                3   /* C  */
+#define TVS_CHANNELS            4
+
+/* Limits for a crossing: supplies +-5 %, junction temperature of the industrial grade */
+#define TVS_1V0_MIN             950
+#define TVS_1V0_MAX             1050
+#define TVS_1V8_MIN             1710
+#define TVS_1V8_MAX             1890
+#define TVS_2V5_MIN             2375
+#define TVS_2V5_MAX             2625
+#define TVS_TEMP_MIN            (-40)
+#define TVS_TEMP_MAX            100
+
+typedef struct
+{
+    uint32_t samples;                   /* valid readings                               */
+    uint32_t failed;                    /* readings with all voltages zero              */
+    int32_t min[TVS_CHANNELS];
+    int32_t max[TVS_CHANNELS];
+    int64_t sum[TVS_CHANNELS];
+    uint32_t crossings;                 /* readings that left the limits of a channel   */
+    uint8_t first_channel;              /* first crossing of the interval               */
+    int32_t first_value;
+    uint64_t first_stamp;               /* mcycle                                       */
+} tvs_stats_t;
+
+/**
+ * functions
+ */
+uint8_t tvs_read(int32_t value[TVS_CHANNELS]);
+void tvs_sample(void);
+void tvs_take(tvs_stats_t *stats);
+
+#endif /* TVS_H_ */
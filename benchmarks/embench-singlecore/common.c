@@ -7,62 +7,165 @@
 
 #include <embench/support.h>
 
-/* Double buffering scheme for log messages: appcores are producers and moncore is consumer. 
- * In other words, appcores generate messages to be printed, but just send them to the moncore,
- * which actually printf the message. This avoid concurrency problems. Still, moncore can break
- * a few messages if an exception occours, but this is what we want... not delaying exceptions. 
+/* Log rings: one single-producer/single-consumer ring per application hart. Appcores
+ * only append to their own ring and publish the new head, so producers never take a
+ * lock or wait for the UART. The moncore is the only consumer: it drains every ring
+ * from forward_log_from_appcore() when the "data ready" software interrupt arrives.
+ * Each entry is a 2-byte header (length, LOG_ENTRY_RECORD for binary records) and the
+ * data. Records are COBS/CRC framed by the moncore when sent, not by the appcore.
+ * A message that does not fit is dropped whole and counted, never written partially.
  */
 
-char log_buffer_0[LOG_BUFFER_SIZE] = {0};
-char log_buffer_1[LOG_BUFFER_SIZE] = {0};
+log_ring_t log_ring[LOG_RING_HARTS];
 
-uint16_t log_buffer_index_0 = 0;
-uint16_t log_buffer_index_1 = 0;
+static void log_ring_put(log_ring_t *ring, uint32_t pos, const uint8_t *data, uint32_t len)
+{
+    uint32_t offset = pos & (LOG_RING_SIZE - 1);
+    uint32_t chunk = ((LOG_RING_SIZE - offset) < len) ? (LOG_RING_SIZE - offset) : len;
 
-bool unblock_pooling = false;
+    memcpy(&ring->data[offset], data, chunk);
+    memcpy(&ring->data[0], data + chunk, len - chunk);
+}
 
-int which_in_use = 0;
-int which_to_save = -1;
-int sessions_logged = 0;
+static void log_ring_get(log_ring_t *ring, uint32_t pos, uint8_t *data, uint32_t len)
+{
+    uint32_t offset = pos & (LOG_RING_SIZE - 1);
+    uint32_t chunk = ((LOG_RING_SIZE - offset) < len) ? (LOG_RING_SIZE - offset) : len;
+
+    memcpy(data, &ring->data[offset], chunk);
+    memcpy(data + chunk, &ring->data[0], len - chunk);
+}
 
-void log_from_appcore_noheader(HART_SHARED_DATA *h_shared, const char *fmt, ...) 
+#if (LOG_TX_ASYNC == 1)
+static logtx_queue_t log_tx_queue[LOG_CHANNELS];
+#endif
+
+/* Moncore output to the UART of a channel, with mutex_uart0 held. Telemetry falls back
+ * to UART0 unless LOG_TELEMETRY_UART1 is set and HART0 has set up MMUART1. With
+ * LOG_TX_ASYNC the bytes are queued and sent by the MMUART interrupt, so the lock is
+ * held for a copy only, unless the transmit ring is full (see logtx.h). */
+static void log_uart_tx(HART_SHARED_DATA *h_shared, uint8_t channel, const uint8_t *data, uint16_t len)
 {
-    uint16_t len = 0;
-    char buf[LOG_MSG_SIZE] = {0};
+    mss_uart_instance_t *uart = h_shared->g_mss_uart0_lo;
 
-    va_list args;
-    va_start(args, fmt);
-    len = vsprintf(buf, fmt, args);
-    va_end(args);
+#if (LOG_TELEMETRY_UART1 == 1)
+    if ((channel == LOG_CHANNEL_TELEMETRY) && (h_shared->g_mss_uart1_lo != NULL))
+    {
+        uart = h_shared->g_mss_uart1_lo;
+    }
+    else
+#endif
+    {
+        channel = LOG_CHANNEL_CONSOLE;
+    }
 
-    spinlock(&h_shared->mutex_uart0);
-    
-    if(which_in_use == 0) 
+#if (LOG_TX_ASYNC == 1)
+    logtx_write(&log_tx_queue[channel], uart, data, len, NULL, NULL);
+#else
+    (void)channel;
+    MSS_UART_polled_tx(uart, data, len);
+#endif
+}
+
+/* Results, error and TVS records go to the telemetry channel, the rest to the console */
+static uint8_t log_record_channel(uint8_t tag)
+{
+    switch (tag >> 3)
     {
-        sprintf(log_buffer_0 + log_buffer_index_0, buf);
-        log_buffer_index_0 += len;
-        sessions_logged++;
+        case LOGBIN_RESULTS:
+        case LOGBIN_RESULTS_DELTA:
+        case LOGBIN_ERROR:
+        case LOGBIN_TVS:
+        case LOGBIN_TVS_STATS:
+        case LOGBIN_HWERR:
+            return LOG_CHANNEL_TELEMETRY;
+        default:
+            return LOG_CHANNEL_CONSOLE;
     }
-    else 
+}
+
+/* Sends one entry to the UART, framing it first if it is a binary record */
+/* Kept out of line so the record and wire buffers stay off the appcore stack */
+__attribute__((noinline)) static void log_entry_tx(HART_SHARED_DATA *h_shared, const uint8_t *data, uint16_t len, uint16_t flags)
+{
+    logbin_record_t rec;
+    uint8_t wire[LOGBIN_WIRE_SIZE];
+    uint8_t channel = LOG_CHANNEL_CONSOLE;
+
+    if (flags & LOG_ENTRY_RECORD)
+    {
+        channel = log_record_channel(data[0]);
+        memcpy(rec.buf, data, len);
+        rec.len = len;
+        rec.overflow = 0;
+        len = logbin_frame(&rec, wire);
+        data = wire;
+    }
+    log_uart_tx(h_shared, channel, data, len);
+}
+
+/* Producer side, called by the hart that owns the ring */
+static void log_ring_write(HART_SHARED_DATA *h_shared, const uint8_t *data, uint16_t len, uint16_t flags)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    log_ring_t *ring;
+    uint32_t head, tail;
+    uint8_t header[2];
+
+    if ((hart_id == 0) || (hart_id > LOG_RING_HARTS))
     {
-        sprintf(log_buffer_1 + log_buffer_index_1, buf);
-        log_buffer_index_1 += len;
-        sessions_logged++;
+        /* The moncore is the consumer, it can write to the UART straight away */
+        spinlock(&h_shared->mutex_uart0);
+        log_entry_tx(h_shared, data, len, flags);
+        spinunlock(&h_shared->mutex_uart0);
+        return;
     }
 
-    if(sessions_logged >= BUFFER_DEPTH)     // Generates data up to n * BUF_SIZE 
-    {   
-        which_to_save = which_in_use;
-        which_in_use = (which_in_use+1)%2;
-        sessions_logged = 0;
-        unblock_pooling = true;   // Unblock HART0 to use this buffer
+    ring = &log_ring[hart_id - 1];
+    head = ring->head;
+    tail = ring->tail;
+
+    if ((len + sizeof(header)) > (LOG_RING_SIZE - (head - tail)))
+    {
+        ring->overflow++;
+        return;
     }
 
-    spinunlock(&h_shared->mutex_uart0);
+    header[0] = (uint8_t)(len | flags);
+    header[1] = (uint8_t)((len | flags) >> 8);
+    log_ring_put(ring, head, header, sizeof(header));
+    log_ring_put(ring, head + sizeof(header), data, len);
+
+    /* Data must be visible before the new head, and the head before tail is read
+     * again below. The consumer does the opposite (tail, fence, head), so at least
+     * one of the two sides sees the other and a doorbell is never lost. */
+    __sync_synchronize();
+    ring->head = head + sizeof(header) + len;
+    __sync_synchronize();
+
+    /* Ring the doorbell only on the empty to non-empty transition */
+    if (ring->tail == head)
+    {
+        raise_soft_interrupt(0);
+    }
+}
+
+/* With LOG_DEFERRED these two names are macros (see common.h), hence the parentheses */
+void (log_from_appcore_noheader)(HART_SHARED_DATA *h_shared, const char *fmt, ...) 
+{
+    uint16_t len = 0;
+    char buf[LOG_MSG_SIZE] = {0};
+
+    va_list args;
+    va_start(args, fmt);
+    len = vsnprintf(buf, LOG_MSG_SIZE, fmt, args);
+    va_end(args);
+
+    log_ring_write(h_shared, (const uint8_t*)buf, (len < LOG_MSG_SIZE) ? len : (LOG_MSG_SIZE - 1), 0);
 }
 
 
-void log_from_appcore(HART_SHARED_DATA *h_shared, const char *fmt, ...) 
+void (log_from_appcore)(HART_SHARED_DATA *h_shared, const char *fmt, ...) 
 {
     uint16_t len = 0;
     char buf[LOG_MSG_SIZE] = {0};
@@ -71,69 +174,626 @@ void log_from_appcore(HART_SHARED_DATA *h_shared, const char *fmt, ...)
     
     va_list args;
     va_start(args, fmt);
-    len += vsprintf(buf+len, fmt, args);
+    len += vsnprintf(buf+len, LOG_MSG_SIZE-len, fmt, args);
     va_end(args);
 
-    spinlock(&h_shared->mutex_uart0);
-    
-    if(which_in_use == 0) 
+    log_ring_write(h_shared, (const uint8_t*)buf, (len < LOG_MSG_SIZE) ? len : (LOG_MSG_SIZE - 1), 0);
+}
+
+void log_record_from_appcore(HART_SHARED_DATA *h_shared, logbin_record_t *rec) 
+{
+    if (rec->overflow == 0)
+    {
+        log_ring_write(h_shared, rec->buf, rec->len, LOG_ENTRY_RECORD);
+    }
+}
+
+#if (LOG_BINARY == 1)
+/* Results of a cycle. Every record carries the CRC-32 of the whole state (errors, execs
+ * and runtime in that order). With LOG_RESULTS_KEYFRAME > 0 only every Nth cycle sends
+ * all of it, the others send the (index, value) pairs that changed since the previous
+ * report; monitor.py applies them and checks the CRC before printing the full block.
+ */
+static uint32_t results_last[3][LOG_RESULTS_MAX];
+static uint8_t results_count;
+
+void log_results_from_appcore(HART_SHARED_DATA *h_shared, uint32_t cycle, uint8_t n, const uint32_t *errors, const uint32_t *execs, const uint32_t *runtime)
+{
+    const uint32_t *state[3] = {errors, execs, runtime};
+    logbin_record_t rec;
+    uint32_t crc = 0;
+    uint8_t changed;
+
+    for (uint8_t j = 0; j < 3; j++)
+    {
+        crc = logbin_crc32(crc, state[j], n);
+    }
+
+    if ((LOG_RESULTS_KEYFRAME == 0) || ((cycle % LOG_RESULTS_KEYFRAME) == 0) ||
+        (n != results_count) || (n > LOG_RESULTS_MAX))
+    {
+        logbin_begin(&rec, LOGBIN_RESULTS, read_csr(mhartid));
+        logbin_put_uint(&rec, cycle);
+        logbin_put_uint(&rec, n);
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            for (uint8_t i = 0; i < n; i++)
+            {
+                logbin_put_uint(&rec, state[j][i]);
+            }
+        }
+        logbin_put_uint(&rec, crc);
+    }
+    else
     {
-        sprintf(log_buffer_0 + log_buffer_index_0, buf);
-        log_buffer_index_0 += len;
-        sessions_logged++;
+        logbin_begin(&rec, LOGBIN_RESULTS_DELTA, read_csr(mhartid));
+        logbin_put_uint(&rec, cycle);
+        logbin_put_uint(&rec, n);
+        logbin_put_uint(&rec, crc);
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            changed = 0;
+            for (uint8_t i = 0; i < n; i++)
+            {
+                changed += (state[j][i] != results_last[j][i]);
+            }
+            logbin_put_uint(&rec, changed);
+            for (uint8_t i = 0; i < n; i++)
+            {
+                if (state[j][i] != results_last[j][i])
+                {
+                    logbin_put_uint(&rec, i);
+                    logbin_put_uint(&rec, state[j][i]);
+                }
+            }
+        }
+    }
+
+    if (n <= LOG_RESULTS_MAX)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            memcpy(results_last[j], state[j], n * sizeof(uint32_t));
+        }
+        results_count = n;
+    }
+
+    log_record_from_appcore(h_shared, &rec);
+}
+#endif
+
+/* [TVS] report: one reading, or with TVS_SAMPLER the statistics of the readings taken
+ * since the previous report, their mean on the usual [TVS] line */
+void log_tvs_from_appcore(HART_SHARED_DATA *h_shared)
+{
+    int32_t value[TVS_CHANNELS];
+    uint8_t valid;
+#if (TVS_SAMPLER == 1)
+    static const char *tvs_channel_name[TVS_CHANNELS] = {"volt_1v0", "volt_1v8", "volt_2v5", "temp"};
+    tvs_stats_t stats;
+
+    tvs_take(&stats);
+    valid = (stats.samples > 0);
+    for (uint8_t i = 0; valid && (i < TVS_CHANNELS); i++)
+    {
+        value[i] = (int32_t)(stats.sum[i] / stats.samples);
+    }
+#else
+    valid = tvs_read(value);
+#endif
+
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+#if (TVS_SAMPLER == 1)
+    logbin_begin(&rec, LOGBIN_TVS_STATS, read_csr(mhartid));
+    logbin_put_uint(&rec, stats.samples);
+    logbin_put_uint(&rec, stats.failed);
+    for (uint8_t i = 0; valid && (i < TVS_CHANNELS); i++)
+    {
+        logbin_put_int(&rec, stats.min[i]);
+        logbin_put_int(&rec, value[i]);
+        logbin_put_int(&rec, stats.max[i]);
+    }
+    logbin_put_uint(&rec, stats.crossings);
+    if (stats.crossings > 0)
+    {
+        logbin_put_uint(&rec, stats.first_channel);
+        logbin_put_int(&rec, stats.first_value);
+        logbin_put_int64(&rec, (int64_t)stats.first_stamp);
+    }
+#else
+    /* An empty TVS record means the read failed */
+    logbin_begin(&rec, LOGBIN_TVS, read_csr(mhartid));
+    if (valid)
+    {
+        logbin_put_uint(&rec, value[TVS_1V0]);
+        logbin_put_uint(&rec, value[TVS_1V8]);
+        logbin_put_uint(&rec, value[TVS_2V5]);
+        logbin_put_int(&rec, value[TVS_TEMP]);
+    }
+#endif
+    log_record_from_appcore(h_shared, &rec);
+#elif (TVS_SAMPLER == 1)
+    char buf[192];
+    uint16_t len = 0;
+
+    if (valid)
+    {
+        log_from_appcore(h_shared, "[TVS] (volt_1v0 = %umV) (volt_1v8 = %umV) (volt_2v5 = %umV) (temp = %dC)\n", 
+            value[TVS_1V0], value[TVS_1V8], value[TVS_2V5], value[TVS_TEMP]);
+        len += snprintf(buf + len, sizeof(buf) - len, " min=(%d, %d, %d, %d) max=(%d, %d, %d, %d)",
+            stats.min[TVS_1V0], stats.min[TVS_1V8], stats.min[TVS_2V5], stats.min[TVS_TEMP],
+            stats.max[TVS_1V0], stats.max[TVS_1V8], stats.max[TVS_2V5], stats.max[TVS_TEMP]);
+    }
+    else
+    {
+        log_from_appcore(h_shared, "[TVS] Reading TVS built-in sensor failed\n");
+    }
+    if (stats.crossings > 0)
+    {
+        snprintf(buf + len, sizeof(buf) - len, " first=%s:%d mcycle=0x%08x%08x", tvs_channel_name[stats.first_channel],
+            stats.first_value, (uint32_t)(stats.first_stamp >> 32), (uint32_t)stats.first_stamp);
     }
-    else 
+    else
     {
-        sprintf(log_buffer_1 + log_buffer_index_1, buf);
-        log_buffer_index_1 += len;
-        sessions_logged++;
+        buf[len] = '\0';
     }
+    log_from_appcore(h_shared, "[TVS] interval: samples=%u failed=%u crossings=%u%s\n\n", stats.samples, stats.failed, stats.crossings, buf);
+#else
+    if (valid)
+    {
+        log_from_appcore(h_shared, "[TVS] (volt_1v0 = %umV) (volt_1v8 = %umV) (volt_2v5 = %umV) (temp = %dC)\n\n", 
+            value[TVS_1V0], value[TVS_1V8], value[TVS_2V5], value[TVS_TEMP]);
+    }  
+    else
+    {
+        log_from_appcore(h_shared, "[TVS] Reading TVS built-in sensor failed\n\n");
+    }
+#endif
+}
 
-    if(sessions_logged >= BUFFER_DEPTH)     // Generates data up to n * BUF_SIZE 
-    {   
-        which_to_save = which_in_use;
-        which_in_use = (which_in_use+1)%2;
-        sessions_logged = 0;
-        unblock_pooling = true;   // Unblock HART0 to use this buffer
+/* Hardware error counters (HWERR_COLLECT) at a cycle boundary: one [HWERR] line per
+ * source that changed since the previous call, nothing if none did */
+void log_hwerr_from_appcore(HART_SHARED_DATA *h_shared)
+{
+    hwerr_delta_t delta[HWERR_SOURCES];
+    uint8_t n = hwerr_collect(delta, HWERR_SOURCES);
+
+    if (n == 0)
+    {
+        return;
     }
 
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+    logbin_begin(&rec, LOGBIN_HWERR, read_csr(mhartid));
+    logbin_put_uint(&rec, n);
+    for (uint8_t i = 0; i < n; i++)
+    {
+        logbin_put_str(&rec, delta[i].name);
+        logbin_put_uint(&rec, delta[i].corrected);
+        logbin_put_uint(&rec, delta[i].uncorrected);
+        logbin_put_uint(&rec, delta[i].cause);
+        logbin_put_int64(&rec, (int64_t)delta[i].addr);
+    }
+    log_record_from_appcore(h_shared, &rec);
+#else
+    for (uint8_t i = 0; i < n; i++)
+    {
+        log_from_appcore(h_shared, "[HWERR] %s: corrected=%u uncorrected=%u cause=%u addr=0x%08x%08x\n", delta[i].name,
+            delta[i].corrected, delta[i].uncorrected, delta[i].cause, (uint32_t)(delta[i].addr >> 32), (uint32_t)delta[i].addr);
+    }
+#endif
+}
+
+/* Error events: workloads call this from their hot loop on a mismatch. It only claims
+ * a slot and fills it, the text or record is built by the moncore when it drains the
+ * queue, so a workload under an error burst runs at the same speed as without errors.
+ * When the queue is full the event is counted and dropped, the workload never waits.
+ */
+log_event_queue_t log_event_queue;
+
+void log_error_event(const char *name, uint32_t errnum, uint32_t itr, const char *syndrome_fmt, uint32_t syndrome0, uint32_t syndrome1)
+{
+    log_event_queue_t *queue = &log_event_queue;
+    log_event_t *slot;
+    uint32_t pos, round;
+    int32_t diff;
+
+    /* Several producers (harts, or FreeRTOS tasks preempting each other) may race for
+     * the same position, the compare-and-swap on head gives it to exactly one */
+    do
+    {
+        pos = queue->head;
+        slot = &queue->slot[pos & (LOG_EVENT_QUEUE_SIZE - 1)];
+        round = pos & ~(LOG_EVENT_QUEUE_SIZE - 1);
+        diff = (int32_t)(slot->seq - round);
+        if (diff < 0)
+        {
+            /* Slot still holds the event of the previous round: queue full */
+            __sync_fetch_and_add(&queue->overflow, 1);
+            return;
+        }
+    } while ((diff != 0) || !__sync_bool_compare_and_swap(&queue->head, pos, pos + 1));
+
+    slot->hart = (uint8_t)read_csr(mhartid);
+    slot->stamp = read_csr(mcycle);
+    slot->name = name;
+    slot->errnum = errnum;
+    slot->itr = itr;
+    slot->syndrome_fmt = syndrome_fmt;
+    slot->syndrome[0] = syndrome0;
+    slot->syndrome[1] = syndrome1;
+
+    /* Same pairing as log_ring_write(): fields before seq, seq before tail is read */
+    __sync_synchronize();
+    slot->seq = round + 1;
+    __sync_synchronize();
+
+    if (queue->tail == pos)
+    {
+        raise_soft_interrupt(0);
+    }
+}
+
+/* Error bursts (moncore only): events of the same workload and hart are merged into one
+ * [BENCHMARK_ERROR] line with the first and last iteration, the count and the distinct
+ * syndromes. A burst is sent when that hart reports another workload or when it has been
+ * open for LOG_BURST_TIMEOUT_MS, and every line takes a token from a bucket refilled at
+ * LOG_ERROR_BUDGET lines per LOG_ERROR_PERIOD_MS. Without a token the burst stays open
+ * and keeps counting, so a persistent fault costs a few lines per period and leaves the
+ * link to TVS and lifecycle messages. Events are only dropped (and counted) when all
+ * burst slots are taken and none can be sent.
+ */
+typedef struct
+{
+    const char *name;                   /* NULL: slot unused                    */
+    const char *syndrome_fmt;
+    uint8_t hart;
+    uint8_t syndromes;                  /* distinct syndromes in syndrome[]     */
+    uint32_t unlisted;                  /* events with a syndrome not listed    */
+    uint32_t count;
+    uint32_t first_itr;
+    uint32_t errnum;                    /* of the last event                    */
+    uint32_t itr;
+    uint64_t stamp;                     /* mcycle of the first event            */
+    uint64_t opened;                    /* HART0 mcycle when the burst opened   */
+    uint32_t syndrome[LOG_BURST_SYNDROMES][2];
+} log_burst_t;
+
+static log_burst_t log_burst[LOG_BURST_SLOTS];
+static uint32_t log_error_tokens = LOG_ERROR_BUDGET;
+static uint64_t log_error_refilled;
+static uint32_t log_error_dropped;
+static uint32_t log_error_dropped_reported;
+
+#define LOG_MS_TO_MCYCLE(ms)    ((uint64_t)(ms) * CPU_MHZ * 1000)
+
+static uint8_t log_error_take_token(void)
+{
+    uint64_t now = read_csr(mcycle);
+    uint64_t step = LOG_MS_TO_MCYCLE(LOG_ERROR_PERIOD_MS) / LOG_ERROR_BUDGET;
+
+    if (log_error_tokens >= LOG_ERROR_BUDGET)
+    {
+        log_error_refilled = now;
+    }
+    while ((log_error_tokens < LOG_ERROR_BUDGET) && ((now - log_error_refilled) >= step))
+    {
+        log_error_tokens++;
+        log_error_refilled += step;
+    }
+
+    if (log_error_tokens == 0)
+    {
+        return 0;
+    }
+    log_error_tokens--;
+    return 1;
+}
+
+/* Sends a burst as the usual [BENCHMARK_ERROR] line (or record). A single event gives
+ * the same line as before, with its syndrome and mcycle stamp in the extra text. */
+static void log_burst_tx(HART_SHARED_DATA *h_shared, const log_burst_t *burst)
+{
+    char extra[192];
+    uint16_t len = 0;
+
+    if (burst->count > 1)
+    {
+        len += snprintf(extra + len, sizeof(extra) - len, " burst=%u first_itr=%u", burst->count, burst->first_itr);
+    }
+    for (uint8_t i = 0; (i < burst->syndromes) && (len < sizeof(extra)); i++)
+    {
+        len += snprintf(extra + len, sizeof(extra) - len, burst->syndrome_fmt, burst->syndrome[i][0], burst->syndrome[i][1]);
+    }
+    if ((burst->unlisted > 0) && (len < sizeof(extra)))
+    {
+        len += snprintf(extra + len, sizeof(extra) - len, " unlisted=%u", burst->unlisted);
+    }
+    if (len < sizeof(extra))
+    {
+        snprintf(extra + len, sizeof(extra) - len, " mcycle=0x%08x%08x", (uint32_t)(burst->stamp >> 32), (uint32_t)burst->stamp);
+    }
+
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+    logbin_begin(&rec, LOGBIN_ERROR, burst->hart);
+    logbin_put_str(&rec, burst->name);
+    logbin_put_uint(&rec, burst->errnum);
+    logbin_put_uint(&rec, burst->itr);
+    logbin_put_str(&rec, extra);
+    if (rec.overflow == 0)
+    {
+        log_entry_tx(h_shared, rec.buf, rec.len, LOG_ENTRY_RECORD);
+    }
+#else
+    char buf[288];
+
+    len = snprintf(buf, sizeof(buf), "\n[BENCHMARK_ERROR] %s: errnum=%u itr=%u%s\n", burst->name, burst->errnum, burst->itr, extra);
+    log_entry_tx(h_shared, (const uint8_t*)buf, (len < sizeof(buf)) ? len : (sizeof(buf) - 1), 0);
+#endif
+}
+
+/* Sends and closes a burst if the budget allows, otherwise it stays open */
+static uint8_t log_burst_flush(HART_SHARED_DATA *h_shared, log_burst_t *burst)
+{
+    if (!log_error_take_token())
+    {
+        return 0;
+    }
+
+    spinlock(&h_shared->mutex_uart0);
+    log_burst_tx(h_shared, burst);
     spinunlock(&h_shared->mutex_uart0);
+
+    burst->name = NULL;
+    return 1;
 }
 
-void forward_log_from_appcore(HART_SHARED_DATA *h_shared) 
+static void log_burst_add(HART_SHARED_DATA *h_shared, const log_event_t *event)
 {
-    /* Print the accumulated messages */
-    if(unblock_pooling == true) 
+    log_burst_t *burst = NULL;
+    log_burst_t *oldest = NULL;
+    uint8_t i;
+
+    for (i = 0; i < LOG_BURST_SLOTS; i++)
     {
-        spinlock(&h_shared->mutex_uart0);
-        
-        if(which_to_save == 0) 
+        log_burst_t *slot = &log_burst[i];
+
+        if (slot->name == NULL)
+        {
+            continue;
+        }
+        if (slot->hart != event->hart)
         {
-            /* Print messages */
-            MSS_UART_polled_tx(h_shared->g_mss_uart0_lo, (const uint8_t*)log_buffer_0, log_buffer_index_0);
-            /* Clear array */
-            memset(log_buffer_0, 0, LOG_BUFFER_SIZE);
-            log_buffer_index_0 = 0;
+            if ((oldest == NULL) || ((int64_t)(slot->opened - oldest->opened) < 0))
+            {
+                oldest = slot;
+            }
         }
-        else 
+        else if (slot->name == event->name)
         {
-            MSS_UART_polled_tx(h_shared->g_mss_uart0_lo, (const uint8_t*)log_buffer_1, log_buffer_index_1);
-            /* Clear array */
-            memset(log_buffer_1, 0, LOG_BUFFER_SIZE);
-            log_buffer_index_1 = 0;
+            burst = slot;
         }
+        else
+        {
+            /* The hart moved on to another workload: that burst is complete */
+            if (!log_burst_flush(h_shared, slot) && ((oldest == NULL) || ((int64_t)(slot->opened - oldest->opened) < 0)))
+            {
+                oldest = slot;
+            }
+        }
+    }
 
-        unblock_pooling = false;
+    if (burst == NULL)
+    {
+        for (i = 0; (i < LOG_BURST_SLOTS) && (burst == NULL); i++)
+        {
+            if (log_burst[i].name == NULL)
+            {
+                burst = &log_burst[i];
+            }
+        }
+        if ((burst == NULL) && (oldest != NULL) && log_burst_flush(h_shared, oldest))
+        {
+            burst = oldest;
+        }
+        if (burst == NULL)
+        {
+            log_error_dropped++;
+            return;
+        }
 
-        spinunlock(&h_shared->mutex_uart0);
+        burst->name = event->name;
+        burst->syndrome_fmt = event->syndrome_fmt;
+        burst->hart = event->hart;
+        burst->syndromes = 0;
+        burst->unlisted = 0;
+        burst->count = 0;
+        burst->first_itr = event->itr;
+        burst->stamp = event->stamp;
+        burst->opened = read_csr(mcycle);
+    }
+
+    burst->count++;
+    burst->errnum = event->errnum;
+    burst->itr = event->itr;
+
+    if (burst->syndrome_fmt != NULL)
+    {
+        for (i = 0; i < burst->syndromes; i++)
+        {
+            if ((burst->syndrome[i][0] == event->syndrome[0]) && (burst->syndrome[i][1] == event->syndrome[1]))
+            {
+                break;
+            }
+        }
+        if (i == burst->syndromes)
+        {
+            if (burst->syndromes < LOG_BURST_SYNDROMES)
+            {
+                burst->syndrome[i][0] = event->syndrome[0];
+                burst->syndrome[i][1] = event->syndrome[1];
+                burst->syndromes++;
+            }
+            else
+            {
+                burst->unlisted++;
+            }
+        }
     }
 }
 
+/* Also called with an empty queue, so HART0 should call forward_log_from_appcore()
+ * periodically (not only on the doorbell) for bursts to be sent on timeout */
+static void forward_error_events(HART_SHARED_DATA *h_shared)
+{
+    log_event_queue_t *queue = &log_event_queue;
+    log_event_t *slot;
+    uint32_t tail = queue->tail;
+    uint64_t now;
 
-void log_from_moncore_noheader_nospinlock(const char *fmt, ...)
+    while (1)
+    {
+        slot = &queue->slot[tail & (LOG_EVENT_QUEUE_SIZE - 1)];
+        if (slot->seq != ((tail & ~(LOG_EVENT_QUEUE_SIZE - 1)) + 1))
+        {
+            /* Empty, or claimed by a producer that has not finished writing it yet
+             * (it rings the doorbell again once it has, as tail is still its position) */
+            break;
+        }
+        __sync_synchronize();
+
+        log_burst_add(h_shared, slot);
+
+        /* Hand the slot to the next round, then publish the new tail */
+        __sync_synchronize();
+        slot->seq = (tail & ~(LOG_EVENT_QUEUE_SIZE - 1)) + LOG_EVENT_QUEUE_SIZE;
+        queue->tail = ++tail;
+        __sync_synchronize();
+    }
+
+    now = read_csr(mcycle);
+    for (uint8_t i = 0; i < LOG_BURST_SLOTS; i++)
+    {
+        if ((log_burst[i].name != NULL) && ((now - log_burst[i].opened) >= LOG_MS_TO_MCYCLE(LOG_BURST_TIMEOUT_MS)))
+        {
+            log_burst_flush(h_shared, &log_burst[i]);
+        }
+    }
+
+    /* Drop reports take a token too, they must not flood the link themselves */
+    if ((queue->overflow != queue->overflow_reported) && log_error_take_token())
+    {
+        queue->overflow_reported = queue->overflow;
+        log_from_moncore(h_shared, "[LOG] error event queue overflow, %u events dropped in total\n", queue->overflow_reported);
+    }
+    if ((log_error_dropped != log_error_dropped_reported) && log_error_take_token())
+    {
+        log_error_dropped_reported = log_error_dropped;
+        log_from_moncore(h_shared, "[LOG] error rate limit, %u events dropped in total\n", log_error_dropped_reported);
+    }
+}
+
+/* Consumer side, moncore only. The doorbell is a software interrupt to HART0, so its
+ * loop can sleep in wfi (MIP_MSIP enabled in mie) and call this when woken. Calling it
+ * from the interrupt handler instead is not safe while HART0 itself may hold mutex_uart0.
+ * The doorbell is cleared first, so a message published during the drain raises it again.
+ */
+void forward_log_from_appcore(HART_SHARED_DATA *h_shared) 
 {
-    char msg[LOG_MSG_SIZE] = {0};
+    char buf[64];
+    uint8_t entry[LOG_MSG_SIZE];
+    uint8_t header[2];
+    uint16_t len, flags;
+
+    clear_soft_interrupt();
+
+#if (LOG_TX_ASYNC == 1)
+    /* Also woken by the MMUART interrupt: release what has gone out, send the rest */
+    spinlock(&h_shared->mutex_uart0);
+    logtx_poll(&log_tx_queue[LOG_CHANNEL_CONSOLE], h_shared->g_mss_uart0_lo);
+#if (LOG_TELEMETRY_UART1 == 1)
+    if (h_shared->g_mss_uart1_lo != NULL)
+    {
+        logtx_poll(&log_tx_queue[LOG_CHANNEL_TELEMETRY], h_shared->g_mss_uart1_lo);
+    }
+#endif
+    spinunlock(&h_shared->mutex_uart0);
+#endif
 
+    for (uint8_t i = 0; i < LOG_RING_HARTS; i++)
+    {
+        log_ring_t *ring = &log_ring[i];
+        uint32_t head, tail;
+
+        tail = ring->tail;
+        head = ring->head;
+        while (head != tail)
+        {
+            /* Read the data only after the head that published it */
+            __sync_synchronize();
+
+            spinlock(&h_shared->mutex_uart0);
+            while (tail != head)
+            {
+                log_ring_get(ring, tail, header, sizeof(header));
+                flags = ((uint16_t)header[1] << 8) & LOG_ENTRY_RECORD;
+                len = (header[0] | ((uint16_t)header[1] << 8)) & ~LOG_ENTRY_RECORD;
+
+                /* The ring is appcore memory: a corrupted head or header must not overrun
+                 * entry[] or the record buffer (which keeps two bytes for the CRC), nor move
+                 * tail past head. Drop what is left and start again from the current head. */
+                if (((head - tail) > LOG_RING_SIZE) || (len > (LOG_MSG_SIZE - 1)) ||
+                    ((len + sizeof(header)) > (head - tail)) ||
+                    ((flags & LOG_ENTRY_RECORD) && (len > (LOGBIN_RECORD_SIZE - 2))))
+                {
+                    ring->corrupted++;
+                    tail = head;
+                    break;
+                }
+                log_ring_get(ring, tail + sizeof(header), entry, len);
+                log_entry_tx(h_shared, entry, len, flags);
+                tail += sizeof(header) + len;
+            }
+            spinunlock(&h_shared->mutex_uart0);
+
+            /* Release the space, then look again for anything published meanwhile */
+            __sync_synchronize();
+            ring->tail = tail;
+            __sync_synchronize();
+            head = ring->head;
+        }
+
+        if (ring->overflow != ring->overflow_reported)
+        {
+            ring->overflow_reported = ring->overflow;
+            len = sprintf(buf, "[HART%d] [LOG] ring overflow, %u messages dropped in total\n", i + 1, ring->overflow);
+            spinlock(&h_shared->mutex_uart0);
+            log_uart_tx(h_shared, LOG_CHANNEL_CONSOLE, (const uint8_t*)buf, len);
+            spinunlock(&h_shared->mutex_uart0);
+        }
+
+        if (ring->corrupted != ring->corrupted_reported)
+        {
+            ring->corrupted_reported = ring->corrupted;
+            len = sprintf(buf, "[HART%d] [LOG] ring corrupted, resynchronised %u times in total\n", i + 1, ring->corrupted);
+            spinlock(&h_shared->mutex_uart0);
+            log_uart_tx(h_shared, LOG_CHANNEL_CONSOLE, (const uint8_t*)buf, len);
+            spinunlock(&h_shared->mutex_uart0);
+        }
+    }
+
+    forward_error_events(h_shared);
+}
+
+
+void log_from_moncore_noheader_nospinlock(const char *fmt, ...)
+{
     va_list args;
     va_start(args, fmt);
     vprintf(fmt, args);
@@ -153,7 +813,7 @@ void log_from_moncore(HART_SHARED_DATA *h_shared, const char *fmt, ...)
     va_end(args);
 
     spinlock(&h_shared->mutex_uart0);
-    MSS_UART_polled_tx(h_shared->g_mss_uart0_lo, (const uint8_t*)buf, len);
+    log_uart_tx(h_shared, LOG_CHANNEL_CONSOLE, (const uint8_t*)buf, len);
     spinunlock(&h_shared->mutex_uart0);
 }
 
@@ -164,6 +824,9 @@ void print_results(HART_SHARED_DATA *h_shared, uint32_t *errors, uint32_t *execs
 
     uint64_t hart_id = read_csr(mhartid);
 
+#if (LOG_BINARY == 1)
+    log_results_from_appcore(h_shared, cycle, WORKLOADS, errors, execs, runtime);
+#else
     len = sprintf(buf, "[HART%d] [BENCHMARK_END] embench_results: %u\n", hart_id, cycle);
 
     len += sprintf(buf+len, "[HART%d]   num_errors = [ ", hart_id);
@@ -188,6 +851,7 @@ void print_results(HART_SHARED_DATA *h_shared, uint32_t *errors, uint32_t *execs
 	len += sprintf(buf+len, "%u ]\n\n", runtime[WORKLOADS-1]);
 
     log_from_appcore_noheader(h_shared, buf);
+#endif
 }
 
 void run_workload
@@ -256,6 +920,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_AHA_MONT64_BATCH == 1)
+        run_workload(
+            "aha-mont64-batch",
+            &mont64_batch_initialise_benchmark, &mont64_batch_warm_caches, &mont64_batch_benchmark, &mont64_batch_verify_benchmark,
+            &mont64_batch_get_errors, &mont64_batch_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_CRC32 == 1)
         run_workload(
             "crc32",
@@ -265,6 +938,24 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_CRC32_SLICE8 == 1)
+        run_workload(
+            "crc32-slice8",
+            &crc32_slice8_initialise_benchmark, &crc32_slice8_warm_caches, &crc32_slice8_benchmark, &crc32_verify_benchmark,
+            &crc32_slice8_get_errors, &crc32_slice8_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
+    #if (ENABLE_WORKLOAD_CRC32_CLMUL == 1)
+        run_workload(
+            "crc32-clmul",
+            &crc32_clmul_initialise_benchmark, &crc32_clmul_warm_caches, &crc32_clmul_benchmark, &crc32_verify_benchmark,
+            &crc32_clmul_get_errors, &crc32_clmul_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_CUBIC == 1)
         run_workload(
             "cubic",
@@ -274,6 +965,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_CUBIC_BATCH == 1)
+        run_workload(
+            "cubic-batch",
+            &cubic_batch_initialise_benchmark, &cubic_batch_warm_caches, &cubic_batch_benchmark, &cubic_batch_verify_benchmark,
+            &cubic_batch_get_errors, &cubic_batch_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_EDN == 1)
         run_workload(
             "edn",
@@ -319,6 +1019,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_NBODY_SOA == 1)
+        run_workload(
+            "nbody-soa",
+            &nbody_soa_initialise_benchmark, &nbody_soa_warm_caches, &nbody_soa_benchmark, &nbody_soa_verify_benchmark,
+            &nbody_soa_get_errors, &nbody_soa_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_NETTLE_AES == 1)
         run_workload(
             "nettle-aes",
@@ -346,6 +1055,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_NSICHNEU_BITS == 1)
+        run_workload(
+            "nsichneu-bits",
+            &nsichneu_bits_initialise_benchmark, &nsichneu_bits_warm_caches, &nsichneu_bits_benchmark, &nsichneu_bits_verify_benchmark,
+            &nsichneu_bits_get_errors, &nsichneu_bits_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_PICOJPEG == 1)
         run_workload(
             "picojpeg",
@@ -355,6 +1073,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_PICOJPEG_STREAM == 1)
+        run_workload(
+            "picojpeg-stream",
+            &picojpeg_stream_initialise_benchmark, &picojpeg_stream_warm_caches, &picojpeg_stream_benchmark, &picojpeg_stream_verify_benchmark,
+            &picojpeg_stream_get_errors, &picojpeg_stream_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_QRDUINO == 1)
         run_workload(
             "qrduino",
@@ -364,6 +1091,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_QRDUINO_LITE == 1)
+        run_workload(
+            "qrduino-lite",
+            &qrduino_lite_initialise_benchmark, &qrduino_lite_warm_caches, &qrduino_lite_benchmark, &qrduino_lite_verify_benchmark,
+            &qrduino_lite_get_errors, &qrduino_lite_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_SGLIB_COMBINED == 1)
         run_workload(
             "sglib-combined",
@@ -382,6 +1118,15 @@ void run_benchmark
         MSS_WD_reload(wdt);
     #endif
 
+    #if (ENABLE_WORKLOAD_SLRE_DFA == 1)
+        run_workload(
+            "slre-dfa",
+            &slre_dfa_initialise_benchmark, &slre_dfa_warm_caches, &slre_dfa_benchmark, &slre_dfa_verify_benchmark,
+            &slre_dfa_get_errors, &slre_dfa_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
+
     #if (ENABLE_WORKLOAD_ST == 1)
         run_workload(
             "st",
@@ -390,6 +1135,14 @@ void run_benchmark
         );
         MSS_WD_reload(wdt);
     #endif
+    #if (ENABLE_WORKLOAD_ST_STREAM == 1)
+        run_workload(
+            "st-stream",
+            &st_stream_initialise_benchmark, &st_stream_warm_caches, &st_stream_benchmark, &st_stream_verify_benchmark,
+            &st_stream_get_errors, &st_stream_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
 
     #if (ENABLE_WORKLOAD_STATEMATE == 1)
         run_workload(
@@ -417,6 +1170,15 @@ void run_benchmark
         );
         MSS_WD_reload(wdt);
     #endif
+
+    #if (ENABLE_WORKLOAD_WIKISORT_PAR == 1)
+        run_workload(
+            "wikisort-par",
+            &wikisort_par_initialise_benchmark, &wikisort_par_warm_caches, &wikisort_par_benchmark, &wikisort_par_verify_benchmark,
+            &wikisort_par_get_errors, &wikisort_par_get_executions, h_shared, &workload_index, errors, execs, runtime
+        );
+        MSS_WD_reload(wdt);
+    #endif
 }
 
 
@@ -11,47 +11,156 @@
 #include "mpfs_hal/mss_hal.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
 #include "drivers/mss/mss_watchdog/mss_watchdog.h"
+#include "logbin.h"
+#include "logtx.h"
+#include "tvs.h"
+#include "hwerr.h"
 
 #ifndef MPFS_HAL_SHARED_MEM_ENABLED
 #endif
 
 #define ENABLE_WORKLOAD_AHA_MONT64      1  /* Montgomery multiplication                                                         */
+#define ENABLE_WORKLOAD_AHA_MONT64_BATCH 0 /* Interleaved modular exponentiation - variant of AHA_MONT64, 8 independent lanes */
 #define ENABLE_WORKLOAD_CRC32           1  /* CRC error checking 32b                                                            */
+#define ENABLE_WORKLOAD_CRC32_SLICE8    0  /* CRC32 slice-by-8 (8 KB tables)   - variant of CRC32, same verification           */
+#define ENABLE_WORKLOAD_CRC32_CLMUL     0  /* CRC32 carry-less multiply        - variant of CRC32, table-free                  */
 #define ENABLE_WORKLOAD_CUBIC           1  /* Cubic root solver                                                                 */
+#define ENABLE_WORKLOAD_CUBIC_BATCH     0  /* 1024 generated cubics per run     - variant of CUBIC, residual checked, no libm   */
 #define ENABLE_WORKLOAD_EDN             1  /* More general filter                                                               */
-#define ENABLE_WORKLOAD_HUFFBENCH       0  /* Compress/decompress              - OFF due to unsafe dynamic memory allocation    */
+#define ENABLE_WORKLOAD_HUFFBENCH       1  /* Compress/decompress                                                               */
 #define ENABLE_WORKLOAD_MATMULT         1  /* Integer matrix multiply                                                           */
 #define ENABLE_WORKLOAD_MINVER          1  /* Matrix inversion                                                                  */
 #define ENABLE_WORKLOAD_NBODY           1  /* Satellite N body, large data                                                      */
+#define ENABLE_WORKLOAD_NBODY_SOA       0  /* N body structure-of-arrays       - variant of NBODY, configurable body count     */
 #define ENABLE_WORKLOAD_NETTLE_AES      1  /* Encrypt/decrypt                                                                   */
 #define ENABLE_WORKLOAD_NETTLE_SHA256   1  /* Crytographic hash                                                                 */
 #define ENABLE_WORKLOAD_NSICHNEU        1  /* Large - Petri net                                                                 */
+#define ENABLE_WORKLOAD_NSICHNEU_BITS   1  /* Petri net from a transition table - variant of NSICHNEU, bit-parallel guards      */
 #define ENABLE_WORKLOAD_PICOJPEG        0  /* JPEG                             - OFF due to memory space limitation and scope   */
+#define ENABLE_WORKLOAD_PICOJPEG_STREAM 1  /* JPEG through a 64 B ring buffer  - variant of PICOJPEG, per-MCU signatures       */
 #define ENABLE_WORKLOAD_QRDUINO         0  /* QR codes                         - OFF due to memory space limitation and scope   */
-#define ENABLE_WORKLOAD_SGLIB_COMBINED  0  /* Simple Generic Library for C     - OFF due to unsafe dynamic memory allocation    */
+#define ENABLE_WORKLOAD_QRDUINO_LITE    1  /* QR codes in a fixed 1.8 KB frame - variant of QRDUINO, no heap, rotating payloads */
+#define ENABLE_WORKLOAD_SGLIB_COMBINED  1  /* Simple Generic Library for C                                                      */
 #define ENABLE_WORKLOAD_SLRE            1  /* Regex                                                                             */
+#define ENABLE_WORKLOAD_SLRE_DFA        0  /* Regex compiled to DFA tables     - variant of SLRE, cross-checked with interpreter */
 #define ENABLE_WORKLOAD_ST              1  /* Statistics                                                                        */
+#define ENABLE_WORKLOAD_ST_STREAM       0  /* Single-pass statistics, 4096 samples - variant of ST, blockwise Welford merge     */
 #define ENABLE_WORKLOAD_STATEMATE       1  /* State machine (car window)                                                        */
 #define ENABLE_WORKLOAD_UD              1  /* LUD composition int                                                               */
 #define ENABLE_WORKLOAD_WIKISORT        1  /* Merge sort                                                                        */
+#define ENABLE_WORKLOAD_WIKISORT_PAR    0  /* Partitioned merge sort           - variant of WIKISORT, configurable size        */
 
 #define WORKLOADS   \
-    (ENABLE_WORKLOAD_AHA_MONT64 + ENABLE_WORKLOAD_CRC32 + ENABLE_WORKLOAD_CUBIC + ENABLE_WORKLOAD_EDN + ENABLE_WORKLOAD_HUFFBENCH + \
-    ENABLE_WORKLOAD_MATMULT + ENABLE_WORKLOAD_MINVER + ENABLE_WORKLOAD_NBODY + ENABLE_WORKLOAD_NETTLE_AES + ENABLE_WORKLOAD_NETTLE_SHA256 + \
-    ENABLE_WORKLOAD_NSICHNEU + ENABLE_WORKLOAD_PICOJPEG + ENABLE_WORKLOAD_QRDUINO + ENABLE_WORKLOAD_SGLIB_COMBINED + ENABLE_WORKLOAD_SLRE + \
-    ENABLE_WORKLOAD_ST + ENABLE_WORKLOAD_STATEMATE + ENABLE_WORKLOAD_UD + ENABLE_WORKLOAD_WIKISORT)
+    (ENABLE_WORKLOAD_AHA_MONT64 + ENABLE_WORKLOAD_AHA_MONT64_BATCH + ENABLE_WORKLOAD_CRC32 + ENABLE_WORKLOAD_CRC32_SLICE8 + ENABLE_WORKLOAD_CRC32_CLMUL + \
+    ENABLE_WORKLOAD_CUBIC + ENABLE_WORKLOAD_CUBIC_BATCH + ENABLE_WORKLOAD_EDN + ENABLE_WORKLOAD_HUFFBENCH + \
+    ENABLE_WORKLOAD_MATMULT + ENABLE_WORKLOAD_MINVER + ENABLE_WORKLOAD_NBODY + ENABLE_WORKLOAD_NBODY_SOA + ENABLE_WORKLOAD_NETTLE_AES + ENABLE_WORKLOAD_NETTLE_SHA256 + \
+    ENABLE_WORKLOAD_NSICHNEU + ENABLE_WORKLOAD_NSICHNEU_BITS + ENABLE_WORKLOAD_PICOJPEG + ENABLE_WORKLOAD_PICOJPEG_STREAM + ENABLE_WORKLOAD_QRDUINO + ENABLE_WORKLOAD_QRDUINO_LITE + ENABLE_WORKLOAD_SGLIB_COMBINED + ENABLE_WORKLOAD_SLRE + ENABLE_WORKLOAD_SLRE_DFA + \
+    ENABLE_WORKLOAD_ST + ENABLE_WORKLOAD_ST_STREAM + ENABLE_WORKLOAD_STATEMATE + ENABLE_WORKLOAD_UD + ENABLE_WORKLOAD_WIKISORT + ENABLE_WORKLOAD_WIKISORT_PAR)
 
 typedef struct HART_SHARED_DATA_
 {
     uint64_t init_marker;
     volatile long mutex_uart0;
     mss_uart_instance_t *g_mss_uart0_lo;
+    mss_uart_instance_t *g_mss_uart1_lo;    /* telemetry (LOG_TELEMETRY_UART1), NULL: UART0 */
 } HART_SHARED_DATA;
 
 
 #define LOG_MSG_SIZE        1024
-#define BUFFER_DEPTH        1
-#define LOG_BUFFER_SIZE     LOG_MSG_SIZE * BUFFER_DEPTH
+#define LOG_RING_HARTS      4       /* HART1..HART4, one log ring each */
+#define LOG_RING_SIZE       2048    /* bytes per ring, power of two    */
+#define LOG_ENTRY_RECORD    0x8000  /* ring entry header: binary record, framed by the moncore */
+#define LOG_EVENT_QUEUE_SIZE 64    /* error events, power of two      */
+#define LOG_BURST_SLOTS     4       /* error bursts coalesced at once  */
+#define LOG_BURST_SYNDROMES 4       /* distinct syndromes per burst    */
+#define LOG_BURST_TIMEOUT_MS 500    /* a burst is sent this long after its first error, budget allowing */
+#define LOG_ERROR_BUDGET    8       /* [BENCHMARK_ERROR] lines (bursts) per LOG_ERROR_PERIOD_MS       */
+#define LOG_ERROR_PERIOD_MS 5000
+
+/* Single-producer/single-consumer log ring: head is only written by the owning
+ * appcore, tail, overflow_reported and corrupted only by the moncore. Indexes run
+ * freely and are masked on access. */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflow;         /* messages dropped because the ring was full */
+    uint32_t overflow_reported;
+    uint32_t corrupted;                 /* bad entry headers skipped by the moncore   */
+    uint32_t corrupted_reported;
+    uint8_t data[LOG_RING_SIZE];
+} log_ring_t;
+
+/* Error event pushed from a workload loop by log_error_event(). The slot of queue
+ * position pos is free when seq is pos & ~(LOG_EVENT_QUEUE_SIZE - 1) and holds an event
+ * when it is that value + 1, so a zeroed queue is empty and needs no initialisation. */
+typedef struct
+{
+    volatile uint32_t seq;
+    uint8_t hart;
+    uint32_t errnum;
+    uint32_t itr;
+    uint32_t syndrome[2];
+    uint64_t stamp;                     /* mcycle when the error was seen              */
+    const char *name;                   /* workload name (literal)                     */
+    const char *syndrome_fmt;           /* e.g. " seed=0x%08x" for syndrome, or NULL   */
+} log_event_t;
+
+/* Multi-producer (any hart or task), single-consumer (moncore) event queue */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflow;         /* events dropped because the queue was full */
+    uint32_t overflow_reported;
+    log_event_t slot[LOG_EVENT_QUEUE_SIZE];
+} log_event_queue_t;
+
+extern log_ring_t log_ring[LOG_RING_HARTS];
+extern log_event_queue_t log_event_queue;
+
+/* 1: results, errors, TVS readings and lifecycle markers are sent as framed binary records
+ * (see logbin.h), decoded back to this text by instrumentation/scripts/monitor.py */
+#define LOG_BINARY          0
+
+/* 1 (needs LOG_BINARY): log_from_appcore() and log_from_appcore_noheader() send a format ID
+ * and their raw arguments, formatting is done by monitor.py with the ELF (--elf). The format
+ * must be a string literal and pointers for %p must be cast to (void *). */
+#define LOG_DEFERRED        0
+
+/* 1: the moncore queues its UART output (logtx.h) and the MMUART interrupt sends it, instead
+ * of polling the UART with mutex_uart0 held. HART0 must enable the MMUART0 interrupt in the
+ * PLIC and call forward_log_from_appcore() whenever it wakes up, from thread context with
+ * interrupts enabled: a write into a full transmit ring waits for that interrupt. */
+#define LOG_TX_ASYNC        0
+
+/* N > 0 (needs LOG_BINARY): the results of a cycle are sent in full every N cycles only, the
+ * other cycles send what changed since the previous report. monitor.py rebuilds the full
+ * block, it needs one full report first (up to N cycles after it starts). */
+#define LOG_RESULTS_KEYFRAME 0
+#define LOG_RESULTS_MAX     64      /* largest workload count kept for delta reports */
+
+/* 1 (needs LOG_BINARY): results, error and TVS records are sent on MMUART1, lifecycle and
+ * other text stays on UART0. HART0 must initialise MMUART1 and set g_mss_uart1_lo (and, with
+ * LOG_TX_ASYNC, enable its interrupt too). Both UARTs are written by the moncore only, under
+ * mutex_uart0, each with its own logtx queue. */
+#define LOG_TELEMETRY_UART1 0
+
+#define LOG_CHANNEL_CONSOLE     0   /* UART0 */
+#define LOG_CHANNEL_TELEMETRY   1   /* UART1 with LOG_TELEMETRY_UART1, otherwise UART0 */
+#define LOG_CHANNELS            2
+
+/* 1: the TVS sensor is read every TVS_SAMPLE_MS from a timer (tvs.h) and each [TVS] report
+ * gives the min/mean/max and limit crossings of the readings since the previous one, instead
+ * of one reading per cycle. Singlecore uses the HART1 SysTick (HART1_TICK_RATE_MS in
+ * mss_sw_config.h must divide TVS_SAMPLE_MS), FreeRTOS a software timer. */
+#define TVS_SAMPLER         0
+#define TVS_SAMPLE_MS       10
+
+/* 1: L2 cache ECC counters and bus error units (hwerr.h) are read at the end of every cycle,
+ * sources that changed are reported as [HWERR] lines (corrected/uncorrected since the
+ * previous cycle, BEU cause, error address) just before the results of the cycle. */
+#define HWERR_COLLECT       0
 
 
 /**
@@ -62,6 +171,42 @@ void log_from_appcore(HART_SHARED_DATA *h_shared, const char *fmt, ...);
 void forward_log_from_appcore(HART_SHARED_DATA *h_shared);
 void log_from_moncore_noheader_nospinlock(const char *fmt, ...);
 void log_from_moncore(HART_SHARED_DATA *h_shared, const char *fmt, ...); 
+void log_record_from_appcore(HART_SHARED_DATA *h_shared, logbin_record_t *rec);
+void log_results_from_appcore(HART_SHARED_DATA *h_shared, uint32_t cycle, uint8_t n, const uint32_t *errors, const uint32_t *execs, const uint32_t *runtime);
+void log_tvs_from_appcore(HART_SHARED_DATA *h_shared);
+void log_hwerr_from_appcore(HART_SHARED_DATA *h_shared);
+void log_error_event(const char *name, uint32_t errnum, uint32_t itr, const char *syndrome_fmt, uint32_t syndrome0, uint32_t syndrome1);
+
+#if (LOG_RESULTS_KEYFRAME > 0) && (LOG_BINARY != 1)
+#error "LOG_RESULTS_KEYFRAME needs LOG_BINARY"
+#endif
+
+#if (LOG_TELEMETRY_UART1 == 1) && (LOG_BINARY != 1)
+#error "LOG_TELEMETRY_UART1 needs LOG_BINARY"
+#endif
+
+#if (LOG_DEFERRED == 1)
+#if (LOG_BINARY != 1)
+#error "LOG_DEFERRED needs LOG_BINARY"
+#endif
+
+/* Format strings are kept in their own section, a string's offset in it is its ID */
+extern const char __start_logfmt[];
+
+#define LOG_TRACE(h_shared, header, fmt, ...)                                               \
+    do                                                                                      \
+    {                                                                                       \
+        static const char logfmt_[] __attribute__((section("logfmt"), used)) = fmt;         \
+        logbin_record_t rec_;                                                               \
+        logbin_begin(&rec_, LOGBIN_TRACE, read_csr(mhartid));                               \
+        logbin_put_uint(&rec_, ((uint32_t)(logfmt_ - __start_logfmt) << 1) | (header));     \
+        LOGBIN_PUT_ARGS(&rec_, ##__VA_ARGS__);                                              \
+        log_record_from_appcore((h_shared), &rec_);                                         \
+    } while (0)
+
+#define log_from_appcore(h_shared, fmt, ...)            LOG_TRACE(h_shared, 1, fmt, ##__VA_ARGS__)
+#define log_from_appcore_noheader(h_shared, fmt, ...)   LOG_TRACE(h_shared, 0, fmt, ##__VA_ARGS__)
+#endif
 
 void print_results(HART_SHARED_DATA *h_shared, uint32_t *errors, uint32_t *execs, uint32_t *runtime, uint32_t cycle);
 void run_workload(char *bench_name, void (*initialise_benchmark)(void),
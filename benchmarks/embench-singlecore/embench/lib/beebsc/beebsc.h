@@ -13,6 +13,7 @@
 #define BEEBSC_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* BEEBS fixes RAND_MAX to its lowest permitted value, 2^15-1 */
 
@@ -43,13 +44,52 @@
 #define double_eq_beebs(exp, actual) (fabs(exp - actual) < VERIFY_DOUBLE_EPS)
 #define double_neq_beebs(exp, actual) !double_eq_beebs(exp, actual)
 
+/* Heap error classes. The first error since init_heap_beebs is kept. */
+
+typedef enum
+{
+  HEAP_OK = 0,
+  HEAP_ERR_EXHAUSTED,		/* Request larger than the free heap */
+  HEAP_ERR_BAD_SIZE,		/* Size calculation overflowed */
+  HEAP_ERR_BAD_POINTER,		/* Pointer outside the heap or misaligned */
+  HEAP_ERR_HEADER,		/* Block header or free list corrupted */
+  HEAP_ERR_OVERRUN,		/* Write past the end of a block */
+  HEAP_ERR_DOUBLE_FREE		/* Block freed twice */
+} heap_error_beebs_t;
+
 /* Local simplified versions of library functions */
 
 int rand_beebs (void);
 void srand_beebs (unsigned int new_seed);
 
+/* Per-workload generator for RANDOM_INPUTS (xorshift32). Inline and with
+   its own state, so that filling inputs costs a few instructions per word
+   and workloads on different harts do not share a seed. The state must not
+   be zero. */
+
+static inline uint32_t
+xorshift32_beebs (uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
 void init_heap_beebs (void *heap, const size_t heap_size);
 int check_heap_beebs (void *heap);
+heap_error_beebs_t heap_error_beebs (void *heap);
+
+/* Allocation from an explicit heap, for workloads that may run
+   concurrently with others */
+void *malloc_arena_beebs (void *heap, size_t size);
+void *calloc_arena_beebs (void *heap, size_t nmemb, size_t size);
+void *realloc_arena_beebs (void *heap, void *ptr, size_t size);
+void free_arena_beebs (void *heap, void *ptr);
+
+/* Allocation from the heap last passed to init_heap_beebs */
 void *malloc_beebs (size_t size);
 void *calloc_beebs (size_t nmemb, size_t size);
 void *realloc_beebs (void *ptr, size_t size);
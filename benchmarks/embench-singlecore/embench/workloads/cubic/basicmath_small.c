@@ -25,16 +25,123 @@
 
 unsigned int cubic_errors;
 unsigned int cubic_executions; 
+unsigned int cubic_batch_errors;
+unsigned int cubic_batch_executions;
 
 static int soln_cnt0;
 static int soln_cnt1;
 static double res0[3];
 static double res1;
 
+/* Returns nonzero if x is not a root of a x^3 + b x^2 + c x + d, that is
+   if |p(x)| exceeds tol times the sum of the coefficient magnitudes times
+   max (1, |x|)^3 */
+
+static int
+cubic_residual_bad (double a, double b, double c, double d, double x,
+		    double tol)
+{
+  double p = ((a * x + b) * x + c) * x + d;
+  double m = fmax (1.0, fabs (x));
+  double scale = (fabs (a) + fabs (b) + fabs (c) + fabs (d)) * m * m * m;
+
+  return !(fabs (p) <= tol * scale);
+}
+
+#if (RANDOM_INPUTS == 1)
+/* Largest scaled residual of a SolveCubic () root */
+#ifndef CUBIC_TOL
+#define CUBIC_TOL 1.0e-12
+#endif
+
+/* Four words per checked cubic */
+static uint32_t cubic_rng;
+static uint32_t cubic_seed;
+static unsigned int cubic_left;
+
+/* The checked cubics of the current draw: coefficients a to d, the root
+   count they must have, the roots found in the last execution and those
+   kept from the first checked one, once their residuals have passed */
+static double cubic_coef[4][4];
+static int cubic_expect[4];
+static int cubic_found[4];
+static double cubic_root[4][3];
+static double cubic_kept_root[4][3];
+static int cubic_kept;
+
+static double
+cubic_unit (void)
+{
+  return (xorshift32_beebs (&cubic_rng) >> 8) * (1.0 / 16777216.0);
+}
+
+/* a (x - r) (x^2 + p x + q) with a in 0.5 .. 2 and r in -8 .. 8. As in the
+   fixed inputs, the first has two more real roots, each at least 0.5 above
+   the previous one, the other three a complex pair at least 0.5 off the
+   real axis, so that the root count does not depend on rounding. */
+static void
+cubic_random_inputs (void)
+{
+  int k;
+
+  cubic_seed = cubic_rng;
+  for (k = 0; k < 4; k++)
+    {
+      double a = 0.5 + 1.5 * cubic_unit ();
+      double r = 16.0 * cubic_unit () - 8.0;
+      double p, q;
+
+      if (0 == k)
+	{
+	  double r2 = r + 0.5 + 4.0 * cubic_unit ();
+	  double r3 = r2 + 0.5 + 4.0 * cubic_unit ();
+
+	  p = -(r2 + r3);
+	  q = r2 * r3;
+	  cubic_expect[k] = 3;
+	}
+      else
+	{
+	  p = 8.0 * cubic_unit () - 4.0;
+	  q = 0.25 * p * p + 0.25 + 4.0 * cubic_unit ();
+	  cubic_expect[k] = 1;
+	}
+
+      cubic_coef[k][0] = a;
+      cubic_coef[k][1] = a * (p - r);
+      cubic_coef[k][2] = a * (q - r * p);
+      cubic_coef[k][3] = -a * r * q;
+    }
+}
+#endif
+
 
 int
 cubic_verify_benchmark (int res __attribute ((unused)) )
 {
+#if (RANDOM_INPUTS == 1)
+  /* Residuals in the first execution checked after a draw, the same roots
+     in the others */
+  int k, j;
+
+  for (k = 0; k < 4; k++)
+    {
+      if (cubic_found[k] != cubic_expect[k])
+	return 0;
+      for (j = 0; j < cubic_found[k]; j++)
+	if (!cubic_kept
+	    ? cubic_residual_bad (cubic_coef[k][0], cubic_coef[k][1],
+				  cubic_coef[k][2], cubic_coef[k][3],
+				  cubic_root[k][j], CUBIC_TOL)
+	    : cubic_root[k][j] != cubic_kept_root[k][j])
+	  return 0;
+    }
+
+  if (!cubic_kept)
+    memcpy (cubic_kept_root, cubic_root, sizeof (cubic_kept_root));
+  cubic_kept = 1;
+  return 1;
+#else
   static const double exp_res0[3] = {2.0, 6.0, 2.5};
   const double exp_res1 = 2.5;
   return (3 == soln_cnt0)
@@ -43,12 +150,18 @@ cubic_verify_benchmark (int res __attribute ((unused)) )
     && double_eq_beebs(exp_res0[2], res0[2])
     && (1 == soln_cnt1)
     && double_eq_beebs(exp_res1, res1);
+#endif
 }
 
 
 void
 cubic_initialise_benchmark (void)
 {
+#if (RANDOM_INPUTS == 1)
+  if (0 == cubic_rng)
+    cubic_rng = 0x63756269U;
+  cubic_left = 0;
+#endif
   cubic_errors = 0;
   cubic_executions = 0;
 }
@@ -74,7 +187,12 @@ cubic_benchmark (void)
     if(cubic_verify_benchmark(cubic_benchmark_body(1)) != 1)
     {
       cubic_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] cubic: errnum=%u itr=%u\n", cubic_errors, cubic_executions);
+#if (RANDOM_INPUTS == 1)
+      cubic_left = 0;
+      log_error_event("cubic", cubic_errors, cubic_executions, " seed=0x%08x", cubic_seed, 0);
+#else
+      log_error_event("cubic", cubic_errors, cubic_executions, NULL, 0, 0);
+#endif
     }
   }
 }
@@ -87,6 +205,25 @@ cubic_benchmark_body (int rpt)
 
   for (i = 0; i < rpt; i++)
     {
+#if (RANDOM_INPUTS == 1)
+      double  a1, b1, c1, d1;
+      int     solutions, k;
+
+      double output[48] = {0};
+      double *output_pos = &(output[0]);
+
+      /* Checked cubics, the grid below stays fixed and unchecked */
+      if (0 == cubic_left)
+	{
+	  cubic_random_inputs ();
+	  cubic_left = RANDOM_INPUTS_PERIOD;
+	  cubic_kept = 0;
+	}
+      cubic_left--;
+      for (k = 0; k < 4; k++)
+	SolveCubic(cubic_coef[k][0], cubic_coef[k][1], cubic_coef[k][2],
+		   cubic_coef[k][3], &cubic_found[k], cubic_root[k]);
+#else
       double  a1 = 1.0, b1 = -10.5, c1 = 32.0, d1 = -30.0;
       double  a2 = 1.0, b2 = -4.5, c2 = 17.0, d2 = -30.0;
       double  a3 = 1.0, b3 = -3.5, c3 = 22.0, d3 = -31.0;
@@ -107,6 +244,7 @@ cubic_benchmark_body (int rpt)
       res1 = output[0];
       SolveCubic(a3, b3, c3, d3, &solutions, output);
       SolveCubic(a4, b4, c4, d4, &solutions, output);
+#endif
       /* Now solve some random equations */
       for(a1=1;a1<3;a1++) {
 	for(b1=10;b1>8;b1--) {
@@ -135,4 +273,183 @@ cubic_get_executions (void)
 }
 
 
+// Batch cubic solver
+
+/* The cubic-batch workload solves CUBIC_BATCH generated cubics per
+   execution with SolveCubicBatch ().  The coefficients are hashed from the
+   set index and an epoch that advances on every execution, so no two
+   executions solve the same equations.  Even sets have random coefficients,
+   odd sets are built from three small integer roots and so often have
+   repeated roots.  Every root must satisfy |p(x)| <= CUBIC_BATCH_TOL times
+   the sum of the coefficient magnitudes times max (1, |x|)^3. */
+
+#ifndef CUBIC_BATCH
+#define CUBIC_BATCH 1024
+#endif
+
+#ifndef CUBIC_BATCH_TOL
+#define CUBIC_BATCH_TOL 1.0e-12
+#endif
+
+#define BATCH_SCALE_FACTOR 1
+/* Constant work per run, 256 * CPU_MHZ cubics */
+#define BATCH_EXECUTIONS \
+  ((BATCH_SCALE_FACTOR * CPU_MHZ * 256) / CUBIC_BATCH)
+
+static double batch_a[CUBIC_BATCH], batch_b[CUBIC_BATCH];
+static double batch_c[CUBIC_BATCH], batch_d[CUBIC_BATCH];
+static double batch_x0[CUBIC_BATCH], batch_x1[CUBIC_BATCH];
+static double batch_x2[CUBIC_BATCH];
+static int batch_solutions[CUBIC_BATCH];
+
+static unsigned int batch_epoch;
+
+/* First failing set of the last execution, for the error log */
+static int batch_bad_set;
+
+/* Integer hash (lowbias32), mapped to [0, 1) */
+static double
+batch_unit (unsigned int h)
+{
+  h ^= h >> 16;
+  h *= 0x7feb352dU;
+  h ^= h >> 15;
+  h *= 0x846ca68bU;
+  h ^= h >> 16;
+  return (h >> 8) * (1.0 / 16777216.0);
+}
+
+static void
+batch_generate (unsigned int epoch)
+{
+  int i;
+
+  for (i = 0; i < CUBIC_BATCH; i++)
+    {
+      unsigned int k = 4 * (epoch * CUBIC_BATCH + i);
+      double u0 = batch_unit (k + 0), u1 = batch_unit (k + 1);
+      double u2 = batch_unit (k + 2), u3 = batch_unit (k + 3);
+      /* Roots in -4 .. 4 */
+      double r1 = floor (9.0 * u1) - 4.0;
+      double r2 = floor (9.0 * u2) - 4.0;
+      double r3 = floor (9.0 * u3) - 4.0;
+      double a = 0.5 + 1.5 * u0;
+
+      batch_a[i] = a;
+      if (i & 1)
+	{
+	  batch_b[i] = -a * (r1 + r2 + r3);
+	  batch_c[i] = a * (r1 * r2 + r1 * r3 + r2 * r3);
+	  batch_d[i] = -a * r1 * r2 * r3;
+	}
+      else
+	{
+	  batch_b[i] = 32.0 * u1 - 16.0;
+	  batch_c[i] = 32.0 * u2 - 16.0;
+	  batch_d[i] = 32.0 * u3 - 16.0;
+	}
+    }
+}
+
+/* Returns nonzero if x is not a root of set i */
+
+static int
+batch_residual_bad (int i, double x)
+{
+  return cubic_residual_bad (batch_a[i], batch_b[i], batch_c[i], batch_d[i],
+			     x, CUBIC_BATCH_TOL);
+}
+
+void
+cubic_batch_initialise_benchmark (void)
+{
+  /* With RANDOM_INPUTS the epochs carry on from the previous cycle */
+#if (RANDOM_INPUTS != 1)
+  batch_epoch = 0;
+#endif
+  cubic_batch_errors = 0;
+  cubic_batch_executions = 0;
+}
+
+
+static int cubic_batch_benchmark_body (int  rpt);
+
+void
+cubic_batch_warm_caches (int  heat)
+{
+  int  res = cubic_batch_benchmark_body (heat);
+
+  return;
+}
+
+
+void
+cubic_batch_benchmark (void)
+{
+  for (unsigned int i = 0; i < BATCH_EXECUTIONS; i++)
+  {
+    cubic_batch_executions++;
+    /* Execute once and check if different of correct */
+    if(cubic_batch_verify_benchmark(cubic_batch_benchmark_body(1)) != 1)
+    {
+      cubic_batch_errors++;
+      log_error_event("cubic-batch", cubic_batch_errors, cubic_batch_executions, " epoch=%u set=%d", batch_epoch - 1, batch_bad_set);
+    }
+  }
+}
+
+
+/* Returns the number of roots that fail the residual check */
+
+static int __attribute__ ((noinline))
+cubic_batch_benchmark_body (int rpt)
+{
+  int bad = 0;
+  int i, j;
+
+  for (j = 0; j < rpt; j++)
+    {
+      batch_generate (batch_epoch++);
+      SolveCubicBatch (batch_a, batch_b, batch_c, batch_d, CUBIC_BATCH,
+		       batch_solutions, batch_x0, batch_x1, batch_x2);
+
+      bad = 0;
+      for (i = 0; i < CUBIC_BATCH; i++)
+	bad += batch_residual_bad (i, batch_x0[i])
+	  + batch_residual_bad (i, batch_x1[i])
+	  + batch_residual_bad (i, batch_x2[i]);
+    }
+
+  batch_bad_set = -1;
+  for (i = 0; bad != 0 && i < CUBIC_BATCH; i++)
+    if (batch_residual_bad (i, batch_x0[i])
+	|| batch_residual_bad (i, batch_x1[i])
+	|| batch_residual_bad (i, batch_x2[i]))
+      {
+	batch_bad_set = i;
+	break;
+      }
+
+  return bad;
+}
+
+int
+cubic_batch_verify_benchmark (int r)
+{
+  return 0 == r;
+}
+
+unsigned int
+cubic_batch_get_errors (void)
+{
+  return cubic_batch_errors;
+}
+
+unsigned int
+cubic_batch_get_executions (void)
+{
+  return cubic_batch_executions;
+}
+
+
 /* vim: set ts=3 sw=3 et: */
@@ -45,6 +45,26 @@
 #define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
 #endif
 
+/* Kernel variant, see KERNEL_* in support.h. The SIMD variant uses SSE2 or
+   AVX2 on a host build; on RISC-V it falls back to the autovec kernels until
+   a vector-capable core is available (hook below). */
+#ifndef EDN_KERNEL
+#define EDN_KERNEL KERNEL_SCALAR
+#endif
+
+#if (EDN_KERNEL == KERNEL_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define EDN_SIMD_ISA 2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define EDN_SIMD_ISA 1
+#elif defined(__riscv_vector)
+/* RVV hook: intrinsics for the dot-product kernels go here. Until then the
+   autovec kernels are used, which GCC vectorises with -march=rv64gcv. */
+#endif
+#endif
+
 #include <stdio.h>
 unsigned int edn_errors;
 unsigned int edn_executions; 
@@ -273,6 +293,278 @@ jpegdct (short *d, short *r)
     }
 }
 
+#if (EDN_KERNEL != KERNEL_SCALAR)
+
+/*****************************************************
+*	Vectorisable kernel variants
+*
+* Same arithmetic as the reference kernels, restructured so that the inner
+* loops are unit-stride, alias-free reductions. iir1 is a true recurrence
+* across its 50 sections and keeps the reference code in every variant.
+*****************************************************/
+#if !defined(EDN_SIMD_ISA)
+static long int
+mac_autovec (const short *restrict a, const short *restrict b, long int sqr,
+	     long int *restrict sum)
+{
+  long int i;
+  long int dotp = 0;
+  long int sq = 0;
+
+  for (i = 0; i < 150; i++)
+    {
+      dotp += b[i] * a[i];
+      sq += b[i] * b[i];
+    }
+
+  *sum += dotp;
+  return sqr + sq;
+}
+
+static void
+fir_autovec (const short *restrict array1, const short *restrict coeff,
+	     long int *restrict output)
+{
+  long int i, j, sum;
+
+  for (i = 0; i < N - ORDER; i++)
+    {
+      sum = 0;
+      for (j = 0; j < ORDER; j++)
+	sum += array1[i + j] * coeff[j];
+      output[i] = sum >> 15;
+    }
+}
+
+/* Both outputs of a pair are plain 32-tap dot products, one sample apart. */
+static void
+fir_no_red_ld_autovec (const short *restrict x, const short *restrict h,
+		       long int *restrict y)
+{
+  long int i, j;
+  long int sum0, sum1;
+
+  for (j = 0; j < 100; j += 2)
+    {
+      sum0 = 0;
+      sum1 = 0;
+      for (i = 0; i < 32; i++)
+	{
+	  sum0 += x[j + i] * h[i];
+	  sum1 += x[j + i + 1] * h[i];
+	}
+      y[j] = sum0 >> 15;
+      y[j + 1] = sum1 >> 15;
+    }
+}
+
+#endif /* !EDN_SIMD_ISA */
+
+/* The lattice state f of each stage is a suffix sum of the b*k products, so
+   the products and the final update vectorise around a short scalar scan. */
+static long int latsynth_f[N];
+static short latsynth_b[N];
+
+static long int
+latsynth_autovec (short *restrict b, const short *restrict k, long int n,
+		  long int f)
+{
+  long int i;
+
+  for (i = 0; i < n; i++)
+    {
+      latsynth_f[i] = b[i] * k[i];
+      latsynth_b[i] = b[i];
+    }
+
+  f -= latsynth_f[n - 1];
+  for (i = n - 2; i >= 0; i--)
+    {
+      f -= latsynth_f[i];
+      latsynth_f[i] = f;
+    }
+
+  for (i = 0; i < n - 1; i++)
+    b[i + 1] = latsynth_b[i] + ((k[i] * (latsynth_f[i] >> 16)) >> 16);
+  b[0] = f >> 16;
+  return f;
+}
+
+/* One pass of the DCT over 8 independent lanes (rows when k = 1, columns
+   when k = 8). Lanes are s elements apart, so the column pass is contiguous. */
+static inline void
+jpegdct_pass (short *restrict d, const short *restrict r, int k, int s,
+	      int m, int n)
+{
+  long int t[12];
+  int j, l;
+
+  for (l = 0; l < 8; l++)
+    {
+      short *dl = d + l * s;
+
+      for (j = 0; j < 4; j++)
+	{
+	  t[j] = dl[k * j] + dl[k * (7 - j)];
+	  t[7 - j] = dl[k * j] - dl[k * (7 - j)];
+	}
+      t[8] = t[0] + t[3];
+      t[9] = t[0] - t[3];
+      t[10] = t[1] + t[2];
+      t[11] = t[1] - t[2];
+      dl[0] = (t[8] + t[10]) >> m;
+      dl[4 * k] = (t[8] - t[10]) >> m;
+      t[8] = (short) (t[11] + t[9]) * r[10];
+      dl[2 * k] = t[8] + (short) ((t[9] * r[9]) >> n);
+      dl[6 * k] = t[8] + (short) ((t[11] * r[11]) >> n);
+      t[0] = (short) (t[4] + t[7]) * r[2];
+      t[1] = (short) (t[5] + t[6]) * r[0];
+      t[2] = t[4] + t[6];
+      t[3] = t[5] + t[7];
+      t[8] = (short) (t[2] + t[3]) * r[8];
+      t[2] = (short) t[2] * r[1] + t[8];
+      t[3] = (short) t[3] * r[3] + t[8];
+      dl[7 * k] = (short) (t[4] * r[4] + t[0] + t[2]) >> n;
+      dl[5 * k] = (short) (t[5] * r[6] + t[1] + t[3]) >> n;
+      dl[3 * k] = (short) (t[6] * r[5] + t[1] + t[2]) >> n;
+      dl[1 * k] = (short) (t[7] * r[7] + t[0] + t[3]) >> n;
+    }
+}
+
+static void
+jpegdct_autovec (short *restrict d, const short *restrict r)
+{
+  jpegdct_pass (d, r, 1, 8, 0, 13);
+  jpegdct_pass (d, r, 8, 1, 3, 16);
+}
+
+#endif /* EDN_KERNEL != KERNEL_SCALAR */
+
+#if defined(EDN_SIMD_ISA)
+
+/*****************************************************
+*	Hand-written SIMD dot products
+*
+* 16x16-bit products are paired by madd into 32-bit lanes and widened into
+* 64-bit accumulators, matching the long int sums of the reference code.
+* A lane only wraps when both of its products are (-32768)^2: its sum of
+* 2^31 reads as INT32_MIN, which no pair can give, so that lane is widened
+* with a zero high word instead of its sign.
+*****************************************************/
+#if (EDN_SIMD_ISA == 2)
+typedef __m256i edn_vec_t;
+#define EDN_VLEN 16
+#define edn_load(p) _mm256_loadu_si256 ((const __m256i *) (p))
+#define edn_zero() _mm256_setzero_si256 ()
+
+static inline edn_vec_t
+edn_madd_acc (edn_vec_t acc, edn_vec_t x, edn_vec_t y)
+{
+  __m256i p = _mm256_madd_epi16 (x, y);
+  __m256i wrap = _mm256_cmpeq_epi32 (p, _mm256_set1_epi32 (INT32_MIN));
+  __m256i high = _mm256_andnot_si256 (wrap, _mm256_srai_epi32 (p, 31));
+
+  acc = _mm256_add_epi64 (acc, _mm256_unpacklo_epi32 (p, high));
+  return _mm256_add_epi64 (acc, _mm256_unpackhi_epi32 (p, high));
+}
+
+static inline long int
+edn_hsum (edn_vec_t acc)
+{
+  __m128i s = _mm_add_epi64 (_mm256_castsi256_si128 (acc),
+			     _mm256_extracti128_si256 (acc, 1));
+  return _mm_cvtsi128_si64 (s) + _mm_cvtsi128_si64 (_mm_unpackhi_epi64 (s, s));
+}
+#else
+typedef __m128i edn_vec_t;
+#define EDN_VLEN 8
+#define edn_load(p) _mm_loadu_si128 ((const __m128i *) (p))
+#define edn_zero() _mm_setzero_si128 ()
+
+static inline edn_vec_t
+edn_madd_acc (edn_vec_t acc, edn_vec_t x, edn_vec_t y)
+{
+  __m128i p = _mm_madd_epi16 (x, y);
+  __m128i wrap = _mm_cmpeq_epi32 (p, _mm_set1_epi32 (INT32_MIN));
+  __m128i high = _mm_andnot_si128 (wrap, _mm_srai_epi32 (p, 31));
+
+  acc = _mm_add_epi64 (acc, _mm_unpacklo_epi32 (p, high));
+  return _mm_add_epi64 (acc, _mm_unpackhi_epi32 (p, high));
+}
+
+static inline long int
+edn_hsum (edn_vec_t acc)
+{
+  return _mm_cvtsi128_si64 (acc)
+    + _mm_cvtsi128_si64 (_mm_unpackhi_epi64 (acc, acc));
+}
+#endif
+
+/* Dot product of len elements: vector body plus scalar tail */
+static inline long int
+edn_dot (const short *x, const short *y, long int len)
+{
+  edn_vec_t acc = edn_zero ();
+  long int i;
+  long int sum;
+
+  for (i = 0; i + EDN_VLEN <= len; i += EDN_VLEN)
+    acc = edn_madd_acc (acc, edn_load (x + i), edn_load (y + i));
+
+  sum = edn_hsum (acc);
+  for (; i < len; i++)
+    sum += x[i] * y[i];
+  return sum;
+}
+
+static long int
+mac_simd (const short *a, const short *b, long int sqr, long int *sum)
+{
+  *sum += edn_dot (b, a, 150);
+  return sqr + edn_dot (b, b, 150);
+}
+
+static void
+fir_simd (const short array1[], const short coeff[], long int output[])
+{
+  long int i;
+
+  for (i = 0; i < N - ORDER; i++)
+    output[i] = edn_dot (array1 + i, coeff, ORDER) >> 15;
+}
+
+static void
+fir_no_red_ld_simd (const short x[], const short h[], long int y[])
+{
+  long int j;
+
+  for (j = 0; j < 100; j++)
+    y[j] = edn_dot (x + j, h, 32) >> 15;
+}
+
+#endif /* EDN_SIMD_ISA */
+
+/* Kernels used by the benchmark body for the selected variant */
+#if defined(EDN_SIMD_ISA)
+#define EDN_MAC             mac_simd
+#define EDN_FIR             fir_simd
+#define EDN_FIR_NO_RED_LD   fir_no_red_ld_simd
+#define EDN_LATSYNTH        latsynth_autovec
+#define EDN_JPEGDCT         jpegdct_autovec
+#elif (EDN_KERNEL != KERNEL_SCALAR)
+#define EDN_MAC             mac_autovec
+#define EDN_FIR             fir_autovec
+#define EDN_FIR_NO_RED_LD   fir_no_red_ld_autovec
+#define EDN_LATSYNTH        latsynth_autovec
+#define EDN_JPEGDCT         jpegdct_autovec
+#else
+#define EDN_MAC             mac
+#define EDN_FIR             fir
+#define EDN_FIR_NO_RED_LD   fir_no_red_ld
+#define EDN_LATSYNTH        latsynth
+#define EDN_JPEGDCT         jpegdct
+#endif
+
 static short a[200];
 static short b[200];
 static short c;
@@ -310,7 +602,7 @@ edn_benchmark (void)
     if(edn_verify_benchmark(edn_benchmark_body(1)) != 1)
     {
       edn_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] edn: errnum=%u itr=%u\n", edn_errors, edn_executions);
+      log_error_event("edn", edn_errors, edn_executions, NULL, 0, 0);
     }
   }
 }
@@ -391,13 +683,13 @@ edn_benchmark_body (int rpt)
        */
 
       vec_mpy1 (a, b, c);
-      c = mac (a, b, (long int) c, (long int *) output);
-      fir (a, b, output);
-      fir_no_red_ld (a, b, output);
-      d = latsynth (a, b, N, d);
+      c = EDN_MAC (a, b, (long int) c, (long int *) output);
+      EDN_FIR (a, b, output);
+      EDN_FIR_NO_RED_LD (a, b, output);
+      d = EDN_LATSYNTH (a, b, N, d);
       iir1 (a, b, &output[100], output);
       e = codebook (d, 1, 17, e, d, a, c, 1);
-      jpegdct (a, b);
+      EDN_JPEGDCT (a, b);
     }
   return 0;
 }
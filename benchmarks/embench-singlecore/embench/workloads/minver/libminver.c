@@ -55,24 +55,50 @@
 
 */
 
+#include <float.h>
 #include <math.h>
 #include <string.h>
 #include "inc/common.h"
 #include <embench/support.h>
 
+/* Order of the matrix.  0 runs the original 3x3 kernel, otherwise a blocked
+   Gauss-Jordan inversion of a MINVER_N x MINVER_N matrix. */
+#ifndef MINVER_N
+#define MINVER_N 0
+#endif
+
 /* This scale factor will be changed to equalise the runtime of the
    benchmarks. */
 #ifdef IS_SIMULATION
 #define LOCAL_SCALE_FACTOR 5
+#elif MINVER_N > 0
+/* Calibrated for MINVER_N = 32, larger matrices run fewer executions */
+#define LOCAL_SCALE_FACTOR 1
+#define NUMBER_OF_EXECUTIONS \
+  ((LOCAL_SCALE_FACTOR * CPU_MHZ * 32 * 32 * 32) \
+   / (MINVER_N * MINVER_N * MINVER_N))
 #else
 #define LOCAL_SCALE_FACTOR 326
 #define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
 #endif
 
 #include <stdio.h>
+#include <stdint.h>
 unsigned int minver_errors;
 unsigned int minver_executions; 
 
+/* RANDOM_INPUTS needs the residual check of the blocked mode, the 3x3
+   kernel keeps its fixed matrix */
+#define MINVER_RANDOM ((RANDOM_INPUTS == 1) && (MINVER_N > 0))
+
+#if MINVER_RANDOM
+/* One word per draw, the hash key of A and v */
+static uint32_t minver_rng;
+static uint32_t minver_seed;
+static unsigned int minver_left;
+#endif
+
+#if MINVER_N == 0
 int minver (int row, int col, float eps);
 int mmul (int row_a, int col_a, int row_b, int col_b);
 
@@ -89,6 +115,7 @@ static float b[3][3] = {
 };
 
 static float a[3][3], c[3][3], d[3][3], det;
+#endif
 
 static float
 minver_fabs (float n)
@@ -102,6 +129,7 @@ minver_fabs (float n)
   return f;
 }
 
+#if MINVER_N == 0
 int
 mmul (int row_a, int col_a, int row_b, int col_b)
 {
@@ -219,11 +247,158 @@ minver (int row, int col, float eps)
 
   return (0);
 }
+#else
+
+/* Blocked Gauss-Jordan.
+
+   Each step inverts a MINVER_NB wide diagonal block in place, scales its
+   block row, updates every other block with one matrix product and then
+   scales its block column.  The matrix is diagonally dominant, which every
+   Schur complement inherits, so no pivoting is needed.  A is hashed from the
+   indices and a key, drawn from a stream with RANDOM_INPUTS.  The
+   inverse is checked by the residual A (A^-1 v) - v for a hashed probe
+   vector v, so no reference matrix is stored. */
+
+#ifndef MINVER_NB
+#define MINVER_NB 8		/* Diagonal block and update tile */
+#endif
+
+/* Largest residual element accepted.  The rounding error of a correct
+   inverse grows with the order and stays about ten times lower. */
+#ifndef MINVER_TOL
+#define MINVER_TOL (MINVER_N * FLT_EPSILON)
+#endif
+
+static float minver_m[MINVER_N][MINVER_N];
+static float minver_w[MINVER_N];
+
+/* Hash key of A and v, drawn from a stream with RANDOM_INPUTS. Any
+   key gives a diagonally dominant A. */
+static uint32_t minver_key = 0x9e3779b9U;
+
+/* A[row][col] for col < MINVER_N, in [-1, 1) plus MINVER_N on the diagonal,
+   v[row] for col == MINVER_N */
+
+static float
+minver_entry (int row, int col)
+{
+  uint32_t h = (uint32_t) (row * (MINVER_N + 1) + col) + minver_key;
+
+  h ^= h >> 16;
+  h *= 0x7feb352dU;
+  h ^= h >> 15;
+  h *= 0x846ca68bU;
+  h ^= h >> 16;
+
+  return (float) (h >> 8) * (1.0f / 8388608.0f) - 1.0f
+    + (row == col ? (float) MINVER_N : 0.0f);
+}
+
+/* Inverts minver_m in place, returns 1 on a pivot below eps */
+
+static int
+minver_blocked (float eps)
+{
+  float t[MINVER_NB];
+  int k0, k1, ii, jj, i, j, k, l;
+
+  for (k0 = 0; k0 < MINVER_N; k0 = k1)
+    {
+      k1 = k0 + MINVER_NB < MINVER_N ? k0 + MINVER_NB : MINVER_N;
+
+      /* Diagonal block D, inverted in place */
+      for (k = k0; k < k1; k++)
+	{
+	  float pivot = minver_m[k][k];
+
+	  if (minver_fabs (pivot) <= eps)
+	    return 1;
+
+	  for (j = k0; j < k1; j++)
+	    if (j != k)
+	      minver_m[k][j] /= pivot;
+
+	  for (i = k0; i < k1; i++)
+	    if (i != k)
+	      {
+		float w = minver_m[i][k];
+
+		for (j = k0; j < k1; j++)
+		  if (j != k)
+		    minver_m[i][j] -= w * minver_m[k][j];
+		minver_m[i][k] = -w / pivot;
+	      }
+
+	  minver_m[k][k] = 1.0f / pivot;
+	}
+
+      /* Block row, D^-1 A[K][j] */
+      for (j = 0; j < MINVER_N; j++)
+	{
+	  if (j >= k0 && j < k1)
+	    continue;
+	  for (i = k0; i < k1; i++)
+	    {
+	      float w = 0.0f;
+
+	      for (l = k0; l < k1; l++)
+		w += minver_m[i][l] * minver_m[l][j];
+	      t[i - k0] = w;
+	    }
+	  for (i = k0; i < k1; i++)
+	    minver_m[i][j] = t[i - k0];
+	}
+
+      /* Other blocks, A[i][j] -= A[i][K] A[K][j], one tile at a time */
+      for (ii = 0; ii < MINVER_N; ii += MINVER_NB)
+	for (jj = 0; jj < MINVER_N; jj += MINVER_NB)
+	  {
+	    int i1 = ii + MINVER_NB < MINVER_N ? ii + MINVER_NB : MINVER_N;
+	    int j1 = jj + MINVER_NB < MINVER_N ? jj + MINVER_NB : MINVER_N;
+
+	    if (ii == k0 || jj == k0)
+	      continue;
+
+	    for (i = ii; i < i1; i++)
+	      for (l = k0; l < k1; l++)
+		{
+		  float w = minver_m[i][l];
+
+		  for (j = jj; j < j1; j++)
+		    minver_m[i][j] -= w * minver_m[l][j];
+		}
+	  }
+
+      /* Block column, -A[i][K] D^-1 */
+      for (i = 0; i < MINVER_N; i++)
+	{
+	  if (i >= k0 && i < k1)
+	    continue;
+	  for (j = k0; j < k1; j++)
+	    {
+	      float w = 0.0f;
+
+	      for (l = k0; l < k1; l++)
+		w += minver_m[i][l] * minver_m[l][j];
+	      t[j - k0] = -w;
+	    }
+	  for (j = k0; j < k1; j++)
+	    minver_m[i][j] = t[j - k0];
+	}
+    }
+
+  return 0;
+}
+#endif
 
 
 int
 minver_verify_benchmark (int res __attribute ((unused)))
 {
+#if MINVER_N > 0
+  /* Singular pivots and residual elements above MINVER_TOL */
+  return 0 == res;
+#else
   int i, j;
   float eps = 1.0e-6;
 
@@ -247,12 +422,18 @@ minver_verify_benchmark (int res __attribute ((unused)))
 	return 0;
 
   return float_eq_beebs(det, -16.6666718);
+#endif
 }
 
 
 void
 minver_initialise_benchmark (void)
 {
+#if MINVER_RANDOM
+  if (0 == minver_rng)
+    minver_rng = 0x6d696e76U;
+  minver_left = 0;
+#endif
   minver_errors = 0;
   minver_executions = 0;
 }
@@ -279,12 +460,75 @@ minver_benchmark (void)
     if(minver_verify_benchmark(minver_benchmark_body(1)) != 1)
     {
       minver_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] minver: errnum=%u itr=%u\n", minver_errors, minver_executions);
+#if MINVER_RANDOM
+      minver_left = 0;
+      log_error_event("minver", minver_errors, minver_executions, " seed=0x%08x", minver_seed, 0);
+#else
+      log_error_event("minver", minver_errors, minver_executions, NULL, 0, 0);
+#endif
     }
   }
 }
 
 
+#if MINVER_N > 0
+/* Returns the number of residual elements above MINVER_TOL, or -1 on a
+   singular pivot */
+
+static int __attribute__ ((noinline))
+minver_benchmark_body (int rpt)
+{
+  int bad = 0;
+  int k;
+
+  for (k = 0; k < rpt; k++)
+    {
+      int i, j;
+
+#if MINVER_RANDOM
+      if (0 == minver_left)
+	{
+	  minver_seed = minver_rng;
+	  minver_key = xorshift32_beebs (&minver_rng);
+	  minver_left = RANDOM_INPUTS_PERIOD;
+	}
+      minver_left--;
+#endif
+      for (i = 0; i < MINVER_N; i++)
+	for (j = 0; j < MINVER_N; j++)
+	  minver_m[i][j] = minver_entry (i, j);
+
+      if (minver_blocked (1.0e-6))
+	{
+	  bad = -1;
+	  continue;
+	}
+
+      /* w = A^-1 v */
+      for (i = 0; i < MINVER_N; i++)
+	{
+	  float w = 0.0f;
+
+	  for (j = 0; j < MINVER_N; j++)
+	    w += minver_m[i][j] * minver_entry (j, MINVER_N);
+	  minver_w[i] = w;
+	}
+
+      /* A w - v, with A hashed again */
+      bad = 0;
+      for (i = 0; i < MINVER_N; i++)
+	{
+	  float r = -minver_entry (i, MINVER_N);
+
+	  for (j = 0; j < MINVER_N; j++)
+	    r += minver_entry (i, j) * minver_w[j];
+	  bad += !(minver_fabs (r) <= MINVER_TOL);
+	}
+    }
+
+  return bad;
+}
+#else
 static int __attribute__ ((noinline))
 minver_benchmark_body (int rpt)
 {
@@ -303,6 +547,7 @@ minver_benchmark_body (int rpt)
 
   return 0;
 }
+#endif
 
 unsigned int
 minver_get_errors (void)
@@ -18,6 +18,7 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 /* This scale factor will be changed to equalise the runtime of the
    benchmarks. */
@@ -1125,11 +1126,64 @@ unsigned char decrypted[LEN];
 struct aes_ctx encctx;
 struct aes_ctx decctx;
 
+#if (RANDOM_INPUTS == 1)
+/* Key words first, then plaintext words */
+static uint32_t aes_rng;
+static uint32_t aes_seed;
+static unsigned int aes_left;
+
+/* Ciphertext of the current draw, kept once the round trip has passed */
+static unsigned char aes_expect[LEN];
+static bool aes_kept;
+
+/* New key and plaintext for every draw */
+static void
+aes_random_inputs (void)
+{
+  unsigned int i;
+
+  aes_seed = aes_rng;
+  for (i = 0; i < sizeof (key); i += 4)
+    {
+      uint32_t w = xorshift32_beebs (&aes_rng);
+
+      memcpy (key + i, &w, 4);
+    }
+  for (i = 0; i < LEN; i += 4)
+    {
+      uint32_t w = xorshift32_beebs (&aes_rng);
+
+      memcpy (plaintext + i, &w, 4);
+    }
+}
+#endif
+
 int
 aes_verify_benchmark (int res __attribute ((unused)))
 {
   bool correct = true;
 
+#if (RANDOM_INPUTS == 1)
+  /* The first execution checked after a draw checks decrypt (encrypt (x))
+     == x, and that no block passes through unciphered. The others check
+     their ciphertext against its one, and the round trip, as for the fixed
+     inputs. */
+  if (0 != memcmp (decrypted, plaintext, LEN))
+    correct = false;
+  if (!aes_kept)
+    {
+      for (unsigned int i = 0; i < LEN; i += AES_BLOCK_SIZE)
+	if (0 == memcmp (encrypted + i, plaintext + i, AES_BLOCK_SIZE))
+	  correct = false;
+      if (correct)
+	{
+	  memcpy (aes_expect, encrypted, LEN);
+	  aes_kept = true;
+	}
+    }
+  else if (0 != memcmp (encrypted, aes_expect, LEN))
+    correct = false;
+#else
   for (unsigned int i = 0; i < LEN; i++)
     {
       if (encrypted[i] != expected[i])
@@ -1137,6 +1191,7 @@ aes_verify_benchmark (int res __attribute ((unused)))
       if (plaintext[i] != decrypted[i])
 	correct = false;
     }
+#endif
 
   return correct;
 }
@@ -1144,6 +1199,11 @@ aes_verify_benchmark (int res __attribute ((unused)))
 void
 aes_initialise_benchmark (void)
 {
+#if (RANDOM_INPUTS == 1)
+  if (0 == aes_rng)
+    aes_rng = 0x6165730aU;
+  aes_left = 0;
+#endif
   aes_errors = 0;
   aes_executions = 0;
 }
@@ -1170,7 +1230,12 @@ aes_benchmark (void)
     if(aes_verify_benchmark(aes_benchmark_body(1)) != 1)
     {
       aes_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] nettle-aes: errnum=%u itr=%u\n", aes_errors, aes_executions);
+#if (RANDOM_INPUTS == 1)
+      aes_left = 0;
+      log_error_event("nettle-aes", aes_errors, aes_executions, " seed=0x%08x", aes_seed, 0);
+#else
+      log_error_event("nettle-aes", aes_errors, aes_executions, NULL, 0, 0);
+#endif
     }
   }
 }
@@ -1183,6 +1248,15 @@ aes_benchmark_body (int rpt)
 
   for (i = 0; i < rpt; i++)
     {
+#if (RANDOM_INPUTS == 1)
+      if (0 == aes_left)
+	{
+	  aes_random_inputs ();
+	  aes_left = RANDOM_INPUTS_PERIOD;
+	  aes_kept = false;
+	}
+      aes_left--;
+#endif
       aes_set_encrypt_key (&encctx, 32, key);
       aes_encrypt (&encctx, LEN, encrypted, plaintext);
 
@@ -25,7 +25,15 @@
 #define LOCAL_SCALE_FACTOR 5
 #else
 #define LOCAL_SCALE_FACTOR 146
-#define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
+#define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ / SHA256_LANES)
+#endif
+
+/* Number of independent messages hashed in lockstep per execution. 1 keeps
+   the original single-buffer benchmark, 4 or 8 select the multi-buffer mode.
+   Executions are divided by the lane count, so the number of hashes per
+   cycle stays the same and the runtime shows the throughput gain. */
+#ifndef SHA256_LANES
+#define SHA256_LANES 1
 #endif
 
 #include <stdio.h>
@@ -423,6 +431,106 @@ struct nettle_hash
 const struct nettle_hash nettle_sha256 = _NETTLE_HASH (sha256, SHA256);
 
 
+#if (SHA256_LANES > 1)
+
+// Multi-buffer SHA-256
+
+/* One 32-bit word per lane. GCC lowers this type to SSE/AVX on a host build
+   and to unrolled scalar code on cores without vector units, so all lanes
+   go through the rounds together in both cases. The round macros above are
+   generic and apply to it unchanged. */
+typedef uint32_t sha256_mb_word __attribute__ ((vector_size (4 * SHA256_LANES)));
+
+#define SHA256_MB_BLOCKS(length) (((length) + 9 + SHA256_BLOCK_SIZE - 1) / SHA256_BLOCK_SIZE)
+
+/* Message schedule word i: loaded data for the first 16 rounds, expanded in
+   place afterwards */
+#define MB_DATA(i) ((i) < 16 ? data[(i)] : EXPAND (data, (i)))
+
+static void
+_nettle_sha256_compress_mb (sha256_mb_word * state, sha256_mb_word * data,
+			    const uint32_t * k)
+{
+  sha256_mb_word A, B, C, D, E, F, G, H;
+  unsigned i;
+
+  A = state[0];
+  B = state[1];
+  C = state[2];
+  D = state[3];
+  E = state[4];
+  F = state[5];
+  G = state[6];
+  H = state[7];
+
+  for (i = 0; i < 64; i += 8, k += 8)
+    {
+      ROUND (A, B, C, D, E, F, G, H, k[0], MB_DATA (i));
+      ROUND (H, A, B, C, D, E, F, G, k[1], MB_DATA (i + 1));
+      ROUND (G, H, A, B, C, D, E, F, k[2], MB_DATA (i + 2));
+      ROUND (F, G, H, A, B, C, D, E, k[3], MB_DATA (i + 3));
+      ROUND (E, F, G, H, A, B, C, D, k[4], MB_DATA (i + 4));
+      ROUND (D, E, F, G, H, A, B, C, k[5], MB_DATA (i + 5));
+      ROUND (C, D, E, F, G, H, A, B, k[6], MB_DATA (i + 6));
+      ROUND (B, C, D, E, F, G, H, A, k[7], MB_DATA (i + 7));
+    }
+
+  state[0] += A;
+  state[1] += B;
+  state[2] += C;
+  state[3] += D;
+  state[4] += E;
+  state[5] += F;
+  state[6] += G;
+  state[7] += H;
+}
+
+/* Hashes SHA256_LANES messages of the same length. Each lane is padded as in
+   MD_PAD, then the blocks of all lanes are compressed together. */
+static void
+sha256_mb_digest (size_t length, const uint8_t (*src)[length],
+		  uint8_t (*digest)[SHA256_DIGEST_SIZE])
+{
+  static uint8_t block[SHA256_LANES][SHA256_MB_BLOCKS (56) * SHA256_BLOCK_SIZE];
+  const size_t blocks = SHA256_MB_BLOCKS (length);
+  sha256_mb_word state[_SHA256_DIGEST_LENGTH];
+  sha256_mb_word data[SHA256_DATA_LENGTH];
+  struct sha256_ctx ctx;
+  size_t b, i, l;
+
+  assert_beebs (blocks * SHA256_BLOCK_SIZE <= sizeof (block[0]));
+
+  for (l = 0; l < SHA256_LANES; l++)
+    {
+      memcpy (block[l], src[l], length);
+      block[l][length] = 0x80;
+      memset (block[l] + length + 1, 0,
+	      blocks * SHA256_BLOCK_SIZE - 8 - length - 1);
+      WRITE_UINT64 (block[l] + blocks * SHA256_BLOCK_SIZE - 8,
+		    (uint64_t) length << 3);
+    }
+
+  sha256_init (&ctx);
+  for (i = 0; i < _SHA256_DIGEST_LENGTH; i++)
+    state[i] = (sha256_mb_word) {} + ctx.state[i];
+
+  for (b = 0; b < blocks; b++)
+    {
+      for (i = 0; i < SHA256_DATA_LENGTH; i++)
+	for (l = 0; l < SHA256_LANES; l++)
+	  data[i][l] = READ_UINT32 (block[l] + b * SHA256_BLOCK_SIZE + 4 * i);
+
+      _nettle_sha256_compress_mb (state, data, K);
+    }
+
+  for (l = 0; l < SHA256_LANES; l++)
+    for (i = 0; i < _SHA256_DIGEST_LENGTH; i++)
+      WRITE_UINT32 (digest[l] + 4 * i, state[i][l]);
+}
+
+#endif /* SHA256_LANES > 1 */
+
+
 // BEEBS benchmark code
 
 unsigned char msg[56] =
@@ -436,9 +544,56 @@ unsigned char hash[32] =
 
 uint8_t buffer[SHA256_DIGEST_SIZE];
 
+#if (SHA256_LANES > 1)
+/* Lane l hashes msg rotated left by l bytes, lane 0 is msg itself */
+static const uint8_t mb_hash[8][SHA256_DIGEST_SIZE] = {
+  { 0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93,
+    0x0c, 0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+    0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 },
+  { 0x22, 0x05, 0x71, 0x23, 0x45, 0x81, 0x5e, 0xc5, 0xad, 0xee, 0x08, 0x21,
+    0x3f, 0xd9, 0xe5, 0x83, 0x12, 0x53, 0xdb, 0x1d, 0x0a, 0xc2, 0x37, 0x64,
+    0xcc, 0xd3, 0x02, 0x29, 0xd7, 0xf8, 0x39, 0x27 },
+  { 0x1d, 0x82, 0xb8, 0xb9, 0x54, 0xc0, 0x9a, 0xcf, 0x90, 0xb4, 0x4f, 0x7e,
+    0x05, 0xbd, 0x7e, 0x3c, 0x24, 0x35, 0xdc, 0x9c, 0x39, 0xc1, 0x74, 0xf1,
+    0x46, 0xff, 0xbb, 0x02, 0xa6, 0x9e, 0xf1, 0x90 },
+  { 0xbc, 0xd8, 0x7f, 0x50, 0x83, 0x68, 0x10, 0x73, 0x48, 0x61, 0x76, 0xba,
+    0x85, 0x5c, 0xb1, 0x3c, 0x49, 0x61, 0x1c, 0x1e, 0x2d, 0x6a, 0x6a, 0x90,
+    0x56, 0xcd, 0x72, 0xdb, 0x78, 0x9a, 0x4c, 0x24 },
+  { 0x31, 0x4a, 0xf1, 0xaa, 0xb0, 0x45, 0x89, 0xb3, 0xbb, 0xdc, 0x1a, 0x51,
+    0x45, 0xce, 0x27, 0xaf, 0x5c, 0xc8, 0xb9, 0xc4, 0x10, 0x4c, 0x76, 0x3f,
+    0x46, 0x16, 0xe3, 0x53, 0x18, 0xe7, 0x58, 0x6a },
+  { 0x48, 0x5e, 0x8f, 0xe2, 0xcb, 0x6e, 0x5b, 0x93, 0x9e, 0x74, 0x93, 0x6a,
+    0x32, 0x4a, 0x61, 0x7b, 0x55, 0xa9, 0x9f, 0x25, 0xa3, 0xca, 0x5b, 0xae,
+    0xc9, 0x18, 0x7d, 0xbf, 0x93, 0xb1, 0xb3, 0x68 },
+  { 0x2d, 0x3a, 0x8a, 0xf6, 0x5d, 0x7c, 0x7f, 0xef, 0x20, 0xd4, 0xa0, 0x30,
+    0x91, 0x76, 0xb8, 0x4c, 0x57, 0x29, 0x3a, 0xf9, 0xe5, 0xf1, 0xf9, 0xbf,
+    0x3b, 0xc4, 0x7c, 0xf5, 0x88, 0x31, 0x50, 0x00 },
+  { 0xaa, 0x9e, 0x95, 0x23, 0xb8, 0x11, 0xc5, 0xc3, 0x8b, 0xb8, 0x31, 0xef,
+    0x8e, 0xa2, 0x04, 0x31, 0x19, 0x57, 0xa2, 0xb2, 0xa2, 0x8b, 0xcc, 0xb1,
+    0x1c, 0x6c, 0xde, 0x01, 0x2b, 0x4d, 0x2b, 0x79 }
+};
+
+static uint8_t mb_msg[SHA256_LANES][sizeof (msg)];
+static uint8_t mb_buffer[SHA256_LANES][SHA256_DIGEST_SIZE];
+
+/* Lanes with a wrong digest in the last verification */
+static unsigned int mb_failed_lanes;
+#endif
+
 int
 sha256_verify_benchmark (int res __attribute ((unused)))
 {
+#if (SHA256_LANES > 1)
+  mb_failed_lanes = 0;
+
+  for (size_t l = 0; l < SHA256_LANES; l++)
+    {
+      if (0 != memcmp (mb_buffer[l], mb_hash[l], SHA256_DIGEST_SIZE))
+	mb_failed_lanes |= 1U << l;
+    }
+
+  return 0 == mb_failed_lanes;
+#else
   bool correct = true;
 
   for (size_t i = 0; i < _SHA256_DIGEST_LENGTH; i++)
@@ -448,11 +603,18 @@ sha256_verify_benchmark (int res __attribute ((unused)))
     }
 
   return correct;
+#endif
 }
 
 void
 sha256_initialise_benchmark (void)
 {
+#if (SHA256_LANES > 1)
+  for (size_t l = 0; l < SHA256_LANES; l++)
+    for (size_t i = 0; i < sizeof (msg); i++)
+      mb_msg[l][i] = msg[(i + l) % sizeof (msg)];
+#endif
+
   sha256_errors = 0;
   sha256_executions = 0;
 }
@@ -479,7 +641,11 @@ sha256_benchmark (void)
     if(sha256_verify_benchmark(sha256_benchmark_body(1)) != 1)
     {
       sha256_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] nettle-sha256: errnum=%u itr=%u\n", sha256_errors, sha256_executions);
+#if (SHA256_LANES > 1)
+      log_error_event("nettle-sha256", sha256_errors, sha256_executions, " lanes=0x%02x", mb_failed_lanes, 0);
+#else
+      log_error_event("nettle-sha256", sha256_errors, sha256_executions, NULL, 0, 0);
+#endif
     }
   }
 }
@@ -492,11 +658,16 @@ sha256_benchmark_body (int rpt)
 
   for (i = 0; i < rpt; i++)
     {
+#if (SHA256_LANES > 1)
+      memset (mb_buffer, 0, sizeof (mb_buffer));
+      sha256_mb_digest (sizeof (msg), mb_msg, mb_buffer);
+#else
       memset (buffer, 0, sizeof (buffer));
       struct sha256_ctx ctx;
       nettle_sha256.init (&ctx);
       nettle_sha256.update (&ctx, sizeof (msg), msg);
       nettle_sha256.digest (&ctx, nettle_sha256.digest_size, buffer);
+#endif
     }
 
   return 0;
@@ -0,0 +1,370 @@
+/* BEEBS nsichneu benchmark, bit-parallel engine
+
+   This file is part of Embench.
+
+   SPDX-License-Identifier: GPL-3.0-or-later */
+
+/* The same NSicherNeu Pr/T-Net as libnsichneu.c, executed from a table
+   instead of the generated if cascade.
+
+   The relations every guard can test are packed into one word: the
+   marking thresholds of P1, P2 and P3, and for each pair of tokens in P1
+   and P2 whether the first is equal to, less than or greater than the
+   second.  Each transition is then a single mask test against that word.
+   The word only changes when a transition fires, which is when it is
+   rebuilt.
+
+   The table holds one row per permutation of the cascade, in the same
+   order, so the transitions fire in the same sequence as the original.
+   The net starts from the same marking and must end in the marking
+   nsichneu_verify_benchmark () expects. */
+
+#include "inc/common.h"
+#include <embench/support.h>
+#include <stdint.h>
+
+/* This scale factor will be changed to equalise the runtime of the
+   benchmarks. */
+#ifdef IS_SIMULATION
+#define LOCAL_SCALE_FACTOR 12
+#else
+#define LOCAL_SCALE_FACTOR 660
+#define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
+#endif
+
+unsigned int nsichneu_bits_errors;
+unsigned int nsichneu_bits_executions;
+
+/* Tokens in each place */
+#define P1_SIZE 3
+#define P2_SIZE 5
+#define P3_SIZE 6
+
+/* Marking thresholds tested by the guards */
+#define REL_P1_GE3   (1ULL << 0)
+#define REL_P2_GE4   (1ULL << 1)
+#define REL_P2_GE5   (1ULL << 2)
+#define REL_P3_ROOM  (1ULL << 3)	/* P3 can take three more tokens */
+
+/* Three bits per token pair (i, j), i < j, in lexicographic order:
+   tok[i] == tok[j], tok[i] < tok[j], tok[i] > tok[j] */
+#define REL_P1_PAIRS 4
+#define REL_P2_PAIRS (REL_P1_PAIRS + 3 * (P1_SIZE * (P1_SIZE - 1) / 2))
+
+struct nsichneu_bits_transition
+{
+  uint64_t need;		/* Relations that enable the transition */
+  unsigned char place;		/* Input place, 1 (T1) or 2 (T2) */
+  unsigned char x, y;		/* Tokens consumed, fired if x < y */
+  unsigned char move;		/* Token kept in P2 as member 0, or 0 */
+};
+
+/* Generated from the cascade in libnsichneu.c */
+static const struct nsichneu_bits_transition nsichneu_bits_table[] = {
+  {0x00000000429ULL, 1, 0, 1, 0},	/* P1 : 0, 1, 2 */
+  {0x00000000509ULL, 1, 0, 2, 0},	/* P1 : 0, 2, 1 */
+  {0x000000000c9ULL, 1, 1, 0, 0},	/* P1 : 1, 0, 2 */
+  {0x00000000889ULL, 1, 1, 2, 0},	/* P1 : 1, 2, 0 */
+  {0x00000000219ULL, 1, 2, 0, 0},	/* P1 : 2, 0, 1 */
+  {0x00000001019ULL, 1, 2, 1, 0},	/* P1 : 2, 1, 0 */
+  {0x0001200400aULL, 2, 0, 1, 0},	/* P2 : 0, 1, 2, 3 */
+  {0x0001200400aULL, 2, 0, 1, 0},	/* P2 : 0, 1, 3, 2 */
+  {0x0040202000aULL, 2, 0, 2, 0},	/* P2 : 0, 2, 1, 3 */
+  {0x0040202000aULL, 2, 0, 2, 0},	/* P2 : 0, 2, 3, 1 */
+  {0x0041010000aULL, 2, 0, 3, 0},	/* P2 : 0, 3, 1, 2 */
+  {0x0041010000aULL, 2, 0, 3, 0},	/* P2 : 0, 3, 2, 1 */
+  {0x0000009800aULL, 2, 1, 0, 0},	/* P2 : 1, 0, 2, 3 */
+  {0x0000009800aULL, 2, 1, 0, 0},	/* P2 : 1, 0, 3, 2 */
+  {0x0040401000aULL, 2, 1, 2, 0},	/* P2 : 1, 2, 0, 3 */
+  {0x0040401000aULL, 2, 1, 2, 0},	/* P2 : 1, 2, 3, 0 */
+  {0x0042008000aULL, 2, 1, 3, 0},	/* P2 : 1, 3, 0, 2 */
+  {0x0042008000aULL, 2, 1, 3, 0},	/* P2 : 1, 3, 2, 0 */
+  {0x000000c200aULL, 2, 2, 0, 0},	/* P2 : 2, 0, 1, 3 */
+  {0x000000c200aULL, 2, 2, 0, 0},	/* P2 : 2, 0, 3, 1 */
+  {0x0001800200aULL, 2, 2, 1, 0},	/* P2 : 2, 1, 0, 3 */
+  {0x0001800200aULL, 2, 2, 1, 0},	/* P2 : 2, 1, 3, 0 */
+  {0x0081008000aULL, 2, 2, 3, 0},	/* P2 : 2, 3, 0, 1 */
+  {0x0081008000aULL, 2, 2, 3, 0},	/* P2 : 2, 3, 1, 0 */
+  {0x0000021200aULL, 2, 3, 0, 0},	/* P2 : 3, 0, 1, 2 */
+  {0x0000021200aULL, 2, 3, 0, 0},	/* P2 : 3, 0, 2, 1 */
+  {0x0004200200aULL, 2, 3, 1, 0},	/* P2 : 3, 1, 0, 2 */
+  {0x0004200200aULL, 2, 3, 1, 0},	/* P2 : 3, 1, 2, 0 */
+  {0x0100201000aULL, 2, 3, 2, 0},	/* P2 : 3, 2, 0, 1 */
+  {0x0100201000aULL, 2, 3, 2, 0},	/* P2 : 3, 2, 1, 0 */
+  {0x0008200400cULL, 2, 0, 1, 3},	/* P2 : 0, 1, 2, 4 */
+  {0x0009000400cULL, 2, 0, 1, 2},	/* P2 : 0, 1, 3, 4 */
+  {0x0008200400cULL, 2, 0, 1, 3},	/* P2 : 0, 1, 4, 2 */
+  {0x0009000400cULL, 2, 0, 1, 2},	/* P2 : 0, 1, 4, 3 */
+  {0x0200202000cULL, 2, 0, 2, 3},	/* P2 : 0, 2, 1, 4 */
+  {0x0240002000cULL, 2, 0, 2, 1},	/* P2 : 0, 2, 3, 4 */
+  {0x0200202000cULL, 2, 0, 2, 3},	/* P2 : 0, 2, 4, 1 */
+  {0x0240002000cULL, 2, 0, 2, 1},	/* P2 : 0, 2, 4, 3 */
+  {0x1001010000cULL, 2, 0, 3, 2},	/* P2 : 0, 3, 1, 4 */
+  {0x1040010000cULL, 2, 0, 3, 1},	/* P2 : 0, 3, 2, 4 */
+  {0x1001010000cULL, 2, 0, 3, 2},	/* P2 : 0, 3, 4, 1 */
+  {0x1040010000cULL, 2, 0, 3, 1},	/* P2 : 0, 3, 4, 2 */
+  {0x0208080000cULL, 2, 0, 4, 3},	/* P2 : 0, 4, 1, 2 */
+  {0x1008080000cULL, 2, 0, 4, 2},	/* P2 : 0, 4, 1, 3 */
+  {0x0208080000cULL, 2, 0, 4, 3},	/* P2 : 0, 4, 2, 1 */
+  {0x1200080000cULL, 2, 0, 4, 1},	/* P2 : 0, 4, 2, 3 */
+  {0x1008080000cULL, 2, 0, 4, 2},	/* P2 : 0, 4, 3, 1 */
+  {0x1200080000cULL, 2, 0, 4, 1},	/* P2 : 0, 4, 3, 2 */
+  {0x0000041800cULL, 2, 1, 0, 3},	/* P2 : 1, 0, 2, 4 */
+  {0x0000048800cULL, 2, 1, 0, 2},	/* P2 : 1, 0, 3, 4 */
+  {0x0000041800cULL, 2, 1, 0, 3},	/* P2 : 1, 0, 4, 2 */
+  {0x0000048800cULL, 2, 1, 0, 2},	/* P2 : 1, 0, 4, 3 */
+  {0x0200401000cULL, 2, 1, 2, 3},	/* P2 : 1, 2, 0, 4 */
+  {0x0240400000cULL, 2, 1, 2, 0},	/* P2 : 1, 2, 3, 4 */
+  {0x0200401000cULL, 2, 1, 2, 3},	/* P2 : 1, 2, 4, 0 */
+  {0x0240400000cULL, 2, 1, 2, 0},	/* P2 : 1, 2, 4, 3 */
+  {0x1002008000cULL, 2, 1, 3, 2},	/* P2 : 1, 3, 0, 4 */
+  {0x1042000000cULL, 2, 1, 3, 0},	/* P2 : 1, 3, 2, 4 */
+  {0x1002008000cULL, 2, 1, 3, 2},	/* P2 : 1, 3, 4, 0 */
+  {0x1042000000cULL, 2, 1, 3, 0},	/* P2 : 1, 3, 4, 2 */
+  {0x0210040000cULL, 2, 1, 4, 3},	/* P2 : 1, 4, 0, 2 */
+  {0x1010040000cULL, 2, 1, 4, 2},	/* P2 : 1, 4, 0, 3 */
+  {0x0210040000cULL, 2, 1, 4, 3},	/* P2 : 1, 4, 2, 0 */
+  {0x1210000000cULL, 2, 1, 4, 0},	/* P2 : 1, 4, 2, 3 */
+  {0x1010040000cULL, 2, 1, 4, 2},	/* P2 : 1, 4, 3, 0 */
+  {0x1210000000cULL, 2, 1, 4, 0},	/* P2 : 1, 4, 3, 2 */
+  {0x0000044200cULL, 2, 2, 0, 3},	/* P2 : 2, 0, 1, 4 */
+  {0x000004c000cULL, 2, 2, 0, 1},	/* P2 : 2, 0, 3, 4 */
+  {0x0000044200cULL, 2, 2, 0, 3},	/* P2 : 2, 0, 4, 1 */
+  {0x000004c000cULL, 2, 2, 0, 1},	/* P2 : 2, 0, 4, 3 */
+  {0x0008800200cULL, 2, 2, 1, 3},	/* P2 : 2, 1, 0, 4 */
+  {0x0009800000cULL, 2, 2, 1, 0},	/* P2 : 2, 1, 3, 4 */
+  {0x0008800200cULL, 2, 2, 1, 3},	/* P2 : 2, 1, 4, 0 */
+  {0x0009800000cULL, 2, 2, 1, 0},	/* P2 : 2, 1, 4, 3 */
+  {0x1080008000cULL, 2, 2, 3, 1},	/* P2 : 2, 3, 0, 4 */
+  {0x1081000000cULL, 2, 2, 3, 0},	/* P2 : 2, 3, 1, 4 */
+  {0x1080008000cULL, 2, 2, 3, 1},	/* P2 : 2, 3, 4, 0 */
+  {0x1081000000cULL, 2, 2, 3, 0},	/* P2 : 2, 3, 4, 1 */
+  {0x0408040000cULL, 2, 2, 4, 3},	/* P2 : 2, 4, 0, 1 */
+  {0x1400040000cULL, 2, 2, 4, 1},	/* P2 : 2, 4, 0, 3 */
+  {0x0408040000cULL, 2, 2, 4, 3},	/* P2 : 2, 4, 1, 0 */
+  {0x1408000000cULL, 2, 2, 4, 0},	/* P2 : 2, 4, 1, 3 */
+  {0x1400040000cULL, 2, 2, 4, 1},	/* P2 : 2, 4, 3, 0 */
+  {0x1408000000cULL, 2, 2, 4, 0},	/* P2 : 2, 4, 3, 1 */
+  {0x0000060200cULL, 2, 3, 0, 2},	/* P2 : 3, 0, 1, 4 */
+  {0x0000061000cULL, 2, 3, 0, 1},	/* P2 : 3, 0, 2, 4 */
+  {0x0000060200cULL, 2, 3, 0, 2},	/* P2 : 3, 0, 4, 1 */
+  {0x0000061000cULL, 2, 3, 0, 1},	/* P2 : 3, 0, 4, 2 */
+  {0x000c000200cULL, 2, 3, 1, 2},	/* P2 : 3, 1, 0, 4 */
+  {0x000c200000cULL, 2, 3, 1, 0},	/* P2 : 3, 1, 2, 4 */
+  {0x000c000200cULL, 2, 3, 1, 2},	/* P2 : 3, 1, 4, 0 */
+  {0x000c200000cULL, 2, 3, 1, 0},	/* P2 : 3, 1, 4, 2 */
+  {0x0300001000cULL, 2, 3, 2, 1},	/* P2 : 3, 2, 0, 4 */
+  {0x0300200000cULL, 2, 3, 2, 0},	/* P2 : 3, 2, 1, 4 */
+  {0x0300001000cULL, 2, 3, 2, 1},	/* P2 : 3, 2, 4, 0 */
+  {0x0300200000cULL, 2, 3, 2, 0},	/* P2 : 3, 2, 4, 1 */
+  {0x2008040000cULL, 2, 3, 4, 2},	/* P2 : 3, 4, 0, 1 */
+  {0x2200040000cULL, 2, 3, 4, 1},	/* P2 : 3, 4, 0, 2 */
+  {0x2008040000cULL, 2, 3, 4, 2},	/* P2 : 3, 4, 1, 0 */
+  {0x2208000000cULL, 2, 3, 4, 0},	/* P2 : 3, 4, 1, 2 */
+  {0x2200040000cULL, 2, 3, 4, 1},	/* P2 : 3, 4, 2, 0 */
+  {0x2208000000cULL, 2, 3, 4, 0},	/* P2 : 3, 4, 2, 1 */
+  {0x0000101200cULL, 2, 4, 0, 3},	/* P2 : 4, 0, 1, 2 */
+  {0x0000108200cULL, 2, 4, 0, 2},	/* P2 : 4, 0, 1, 3 */
+  {0x0000101200cULL, 2, 4, 0, 3},	/* P2 : 4, 0, 2, 1 */
+  {0x0000109000cULL, 2, 4, 0, 1},	/* P2 : 4, 0, 2, 3 */
+  {0x0000108200cULL, 2, 4, 0, 2},	/* P2 : 4, 0, 3, 1 */
+  {0x0000109000cULL, 2, 4, 0, 1},	/* P2 : 4, 0, 3, 2 */
+  {0x0020200200cULL, 2, 4, 1, 3},	/* P2 : 4, 1, 0, 2 */
+  {0x0021000200cULL, 2, 4, 1, 2},	/* P2 : 4, 1, 0, 3 */
+  {0x0020200200cULL, 2, 4, 1, 3},	/* P2 : 4, 1, 2, 0 */
+  {0x0021200000cULL, 2, 4, 1, 0},	/* P2 : 4, 1, 2, 3 */
+  {0x0021000200cULL, 2, 4, 1, 2},	/* P2 : 4, 1, 3, 0 */
+  {0x0021200000cULL, 2, 4, 1, 0},	/* P2 : 4, 1, 3, 2 */
+  {0x0800201000cULL, 2, 4, 2, 3},	/* P2 : 4, 2, 0, 1 */
+  {0x0840001000cULL, 2, 4, 2, 1},	/* P2 : 4, 2, 0, 3 */
+  {0x0800201000cULL, 2, 4, 2, 3},	/* P2 : 4, 2, 1, 0 */
+  {0x0840200000cULL, 2, 4, 2, 0},	/* P2 : 4, 2, 1, 3 */
+  {0x0840001000cULL, 2, 4, 2, 1},	/* P2 : 4, 2, 3, 0 */
+  {0x0840200000cULL, 2, 4, 2, 0},	/* P2 : 4, 2, 3, 1 */
+  {0x4001008000cULL, 2, 4, 3, 2},	/* P2 : 4, 3, 0, 1 */
+  {0x4040008000cULL, 2, 4, 3, 1},	/* P2 : 4, 3, 0, 2 */
+  {0x4001008000cULL, 2, 4, 3, 2},	/* P2 : 4, 3, 1, 0 */
+  {0x4041000000cULL, 2, 4, 3, 0},	/* P2 : 4, 3, 1, 2 */
+  {0x4040008000cULL, 2, 4, 3, 1},	/* P2 : 4, 3, 2, 0 */
+  {0x4041000000cULL, 2, 4, 3, 0},	/* P2 : 4, 3, 2, 1 */
+};
+
+#define TRANSITIONS \
+  (sizeof (nsichneu_bits_table) / sizeof (nsichneu_bits_table[0]))
+
+static int p1_marked;
+static long p1_member[P1_SIZE];
+static int p2_marked;
+static long p2_member[P2_SIZE];
+static int p3_marked;
+static long p3_member[P3_SIZE];
+
+static uint64_t
+relate_tokens (const long *tok, int n, int shift)
+{
+  uint64_t rel = 0;
+  int i, j;
+
+  for (i = 0; i < n; i++)
+    for (j = i + 1; j < n; j++)
+      {
+	int r = (tok[i] == tok[j]) ? 0 : (tok[i] < tok[j]) ? 1 : 2;
+
+	rel |= 1ULL << (shift + r);
+	shift += 3;
+      }
+
+  return rel;
+}
+
+static uint64_t
+relate_marking (void)
+{
+  uint64_t rel;
+
+  rel = relate_tokens (p1_member, P1_SIZE, REL_P1_PAIRS)
+    | relate_tokens (p2_member, P2_SIZE, REL_P2_PAIRS);
+  if (p1_marked >= 3)
+    rel |= REL_P1_GE3;
+  if (p2_marked >= 4)
+    rel |= REL_P2_GE4;
+  if (p2_marked >= 5)
+    rel |= REL_P2_GE5;
+  if (p3_marked + 3 <= P3_SIZE)
+    rel |= REL_P3_ROOM;
+
+  return rel;
+}
+
+static void
+fire (const struct nsichneu_bits_transition *t)
+{
+  long x, y, z;
+
+  /* demarking of input places */
+  if (t->place == 1)
+    {
+      x = p1_member[t->x];
+      y = p1_member[t->y];
+      p1_marked -= 3;
+      z = x - y;
+    }
+  else
+    {
+      x = p2_member[t->x];
+      y = p2_member[t->y];
+      if (t->move)
+	p2_member[0] = p2_member[t->move];
+      p2_marked -= 4;
+      z = x + y;
+    }
+
+  /* marking of output places */
+  p3_member[p3_marked + 0] = x;
+  p3_member[p3_marked + 1] = y;
+  p3_member[p3_marked + 2] = z;
+  p3_marked += 3;
+}
+
+void
+nsichneu_bits_initialise_benchmark (void)
+{
+  nsichneu_bits_errors = 0;
+  nsichneu_bits_executions = 0;
+}
+
+
+static int nsichneu_bits_benchmark_body (int  rpt);
+
+void
+nsichneu_bits_warm_caches (int  heat)
+{
+  int  res = nsichneu_bits_benchmark_body (heat);
+
+  return;
+}
+
+
+void
+nsichneu_bits_benchmark (void)
+{
+  for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
+  {
+    nsichneu_bits_executions++;
+    /* Execute once and check if different of correct */
+    if(nsichneu_bits_verify_benchmark(nsichneu_bits_benchmark_body(1)) != 1)
+    {
+      nsichneu_bits_errors++;
+      log_error_event("nsichneu-bits", nsichneu_bits_errors, nsichneu_bits_executions, NULL, 0, 0);
+    }
+  }
+}
+
+
+static int __attribute__ ((noinline))
+nsichneu_bits_benchmark_body (int rpt)
+{
+  int j;
+
+  for (j = 0; j < rpt; j++)
+    {
+      const struct nsichneu_bits_transition *t;
+      uint64_t rel;
+
+      p1_marked = 3;
+      p2_marked = 5;
+      p3_marked = 0;
+
+      rel = relate_marking ();
+      for (t = nsichneu_bits_table; t < nsichneu_bits_table + TRANSITIONS; t++)
+	if ((rel & t->need) == t->need)
+	  {
+	    fire (t);
+	    rel = relate_marking ();
+	  }
+    }
+
+  return 0;
+}
+
+
+int
+nsichneu_bits_verify_benchmark (int unused)
+{
+  int i;
+
+  if (p1_marked != 3 || p2_marked != 5 || p3_marked != 0)
+    return 0;
+
+  /* Every token is expected to be zero, as in the original */
+  for (i = 0; i < P1_SIZE; i++)
+    if (p1_member[i] != 0)
+      return 0;
+  for (i = 0; i < P2_SIZE; i++)
+    if (p2_member[i] != 0)
+      return 0;
+  for (i = 0; i < P3_SIZE; i++)
+    if (p3_member[i] != 0)
+      return 0;
+
+  return 1;
+}
+
+unsigned int
+nsichneu_bits_get_errors (void)
+{
+  return nsichneu_bits_errors;
+}
+
+unsigned int
+nsichneu_bits_get_executions (void)
+{
+  return nsichneu_bits_executions;
+}
+
+/*
+   Local Variables:
+   mode: C
+   c-file-style: "gnu"
+   End:
+*/
@@ -31,13 +31,25 @@ void picojpeg_warm_caches(int temperature);
 /* Every benchmark implements this as its entry point. Don't allow it to be
    inlined! */
 
-int picojpeg_benchmark(void) __attribute__ ((noinline));
+void picojpeg_benchmark(void) __attribute__ ((noinline));
 
 /* Every benchmark must implement this to validate the result of the
    benchmark. */
 
 int picojpeg_verify_benchmark(int res);
 
+/* Custom functions to allow checking each of the N executions of the benchmark */
+unsigned int picojpeg_get_errors(void);
+unsigned int picojpeg_get_executions(void);
+
+/* Streaming variant, reading the image through a small ring buffer */
+void picojpeg_stream_initialise_benchmark(void);
+void picojpeg_stream_warm_caches(int temperature);
+void picojpeg_stream_benchmark(void) __attribute__ ((noinline));
+int picojpeg_stream_verify_benchmark(int res);
+unsigned int picojpeg_stream_get_errors(void);
+unsigned int picojpeg_stream_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* PICOJPEG_TEST_H */
@@ -37,6 +37,15 @@ void qrencode (void);
 
 void freeecc (void);
 
+// use a fixed buffer instead of the heap, NULL to go back to the heap
+void qrframe_use_buffer (unsigned char *buf, unsigned size);
+
+// fixed buffer size for versions up to v (v <= 9, where the ECC buffers
+// are at their 768 byte minimum)
+#define QRFIXED_WD(v) (17 + 4 * (v))
+#define QRFIXED_SIZE(v) (2 * 768 + QRFIXED_WD (v) * ((QRFIXED_WD (v) + 7) / 8) \
+  + (QRFIXED_WD (v) * (QRFIXED_WD (v) + 1) / 2 + 7) / 8 + QRFIXED_WD (v) + 1)
+
 
 /*
    Local Variables:
@@ -35,6 +35,45 @@ unsigned char *rlens;
 unsigned char VERSION;
 unsigned char WD, WDB;		// filled in from verison by initframe
 
+/* Optional fixed buffer. Once set with qrframe_use_buffer, the frame and
+   ECC buffers are carved from it at each initecc instead of coming from the
+   BEEBS heap, and freeframe/freeecc do nothing. */
+static unsigned char *fixed_buf;
+static unsigned fixed_size, fixed_used;
+
+void
+qrframe_use_buffer (unsigned char *buf, unsigned size)
+{
+  fixed_buf = buf;
+  fixed_size = size;
+  fixed_used = 0;
+}
+
+static unsigned char *
+qralloc (unsigned size, int zero)
+{
+  unsigned char *p;
+
+  if (NULL == fixed_buf)
+    return zero ? calloc_beebs (size, 1) : malloc_beebs (size);
+
+  if (size > fixed_size - fixed_used)
+    return NULL;
+
+  p = fixed_buf + fixed_used;
+  fixed_used += size;
+  if (zero)
+    memset (p, 0, size);
+  return p;
+}
+
+static void
+qrfree (unsigned char *p)
+{
+  if (NULL == fixed_buf)
+    free_beebs (p);
+}
+
 #define QRBIT(x,y) ( ( framebase[((x)>>3) + (y) * WDB] >> (7-((x) & 7 ))) & 1 )
 #define SETQRBIT(x,y) framebase[((x)>>3) + (y) * WDB] |= 0x80 >> ((x) & 7)
 
@@ -186,9 +225,9 @@ initframe (void)
 {
   unsigned x, y;
 
-  framebase = calloc_beebs (WDB * WD, 1);
-  framask = calloc_beebs (((WD * (WD + 1) / 2) + 7) / 8, 1);
-  rlens = malloc_beebs (WD + 1);
+  framebase = qralloc (WDB * WD, 1);
+  framask = qralloc (((WD * (WD + 1) / 2) + 7) / 8, 1);
+  rlens = qralloc (WD + 1, 0);
   // finders
   putfind ();
   // alignment blocks
@@ -242,9 +281,9 @@ initframe (void)
 void
 freeframe (void)
 {
-  free_beebs (framebase);
-  free_beebs (framask);
-  free_beebs (rlens);
+  qrfree (framebase);
+  qrfree (framask);
+  qrfree (rlens);
 }
 
 unsigned char *strinbuf;
@@ -273,7 +312,8 @@ initecc (unsigned char ecc, unsigned char vers)
   unsigned fsz = WD * WDB;
   if (fsz < 768)		// for ECC math buffers
     fsz = 768;
-  qrframe = malloc_beebs (fsz);
+  fixed_used = 0;
+  qrframe = qralloc (fsz, 0);
 
   ECCLEVEL = ecc;
   unsigned eccindex = (ecc - 1) * 4 + (vers - 1) * 16;
@@ -288,7 +328,7 @@ initecc (unsigned char ecc, unsigned char vers)
 		  neccblk2))
     fsz =
       datablkw + (datablkw + eccblkwid) * (neccblk1 + neccblk2) + neccblk2;
-  strinbuf = malloc_beebs (fsz);
+  strinbuf = qralloc (fsz, 0);
   return datablkw * (neccblk1 + neccblk2) + neccblk2 - 3;	//-2 if vers <= 9!
 }
 
@@ -312,8 +352,8 @@ initeccsize (unsigned char ecc, unsigned size)
 void
 freeecc (void)
 {
-  free_beebs (qrframe);
-  free_beebs (strinbuf);
+  qrfree (qrframe);
+  qrfree (strinbuf);
 }
 
 
@@ -42,6 +42,14 @@ int slre_verify_benchmark(int res);
 unsigned int slre_get_errors(void);
 unsigned int slre_get_executions(void);
 
+/* Compiled matcher variant (slre-dfa workload) */
+void slre_dfa_initialise_benchmark(void);
+void slre_dfa_warm_caches(int temperature);
+void slre_dfa_benchmark(void) __attribute__ ((noinline));
+int slre_dfa_verify_benchmark(int res);
+unsigned int slre_dfa_get_errors(void);
+unsigned int slre_dfa_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* LIBSLRE_H */
@@ -45,6 +45,8 @@
 #include <stdio.h>
 unsigned int st_errors;
 unsigned int st_executions; 
+unsigned int st_stream_errors;
+unsigned int st_stream_executions;
 
 #define MAX 100
 
@@ -97,7 +99,7 @@ st_benchmark (void)
     if(st_verify_benchmark(st_benchmark_body(1)) != 1)
     {
       st_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] st: errnum=%u itr=%u\n", st_errors, st_executions);
+      log_error_event("st", st_errors, st_executions, NULL, 0, 0);
     }
   }
 }
@@ -245,6 +247,226 @@ st_get_executions (void)
 }
 
 
+// Single-pass streaming statistics
+
+/* The st-stream workload computes the same statistics over two series of
+   ST_STREAM_N values in one pass.  Each ST_STREAM_BLOCK slice is reduced
+   to a count, means, squared deviations and co-moment with short loops the
+   compiler can vectorise, and the slice is merged into the running totals
+   with the pairwise Welford update (Chan et al.).  The results must stay
+   within ST_STREAM_TOL of the multi-pass reference computed at
+   initialisation. */
+
+#ifndef ST_STREAM_N
+#define ST_STREAM_N 4096
+#endif
+
+#ifndef ST_STREAM_BLOCK
+#define ST_STREAM_BLOCK 64
+#endif
+
+#ifndef ST_STREAM_TOL
+#define ST_STREAM_TOL 1.0e-9	/* Relative */
+#endif
+
+#ifdef IS_SIMULATION
+#define STREAM_SCALE_FACTOR 1
+#else
+#define STREAM_SCALE_FACTOR 14
+#endif
+/* Constant work per run, calibrated for ST_STREAM_N = 4096 */
+#define STREAM_EXECUTIONS \
+  ((STREAM_SCALE_FACTOR * CPU_MHZ * 4096) / ST_STREAM_N)
+
+/* Sums, means, variances, standard deviations and correlation */
+#define ST_STREAM_STATS 9
+
+static double stream_a[ST_STREAM_N], stream_b[ST_STREAM_N];
+static double stream_ref[ST_STREAM_STATS];
+static double stream_res[ST_STREAM_STATS];
+
+/* Statistics outside the tolerance in the last execution, one bit each */
+static unsigned int stream_bad;
+
+void
+st_stream_initialise_benchmark (void)
+{
+  double sum_a = 0.0, sum_b = 0.0, mean_a, mean_b;
+  double var_a = 0.0, var_b = 0.0, num = 0.0;
+  int i;
+
+  /* The original series repeated every MAX values */
+  InitSeedST ();
+  for (i = 0; i < ST_STREAM_N; i++)
+    {
+      stream_a[i] = i % MAX + RandomIntegerST () / 8095.0;
+      stream_b[i] = i % MAX + RandomIntegerST () / 8095.0;
+    }
+
+  /* Multi-pass reference, as Calc_Sum_Mean (), Calc_Var_Stddev () and
+     Calc_LinCorrCoef () */
+  for (i = 0; i < ST_STREAM_N; i++)
+    {
+      sum_a += stream_a[i];
+      sum_b += stream_b[i];
+    }
+  mean_a = sum_a / ST_STREAM_N;
+  mean_b = sum_b / ST_STREAM_N;
+
+  for (i = 0; i < ST_STREAM_N; i++)
+    {
+      var_a += Square (stream_a[i] - mean_a);
+      var_b += Square (stream_b[i] - mean_b);
+    }
+
+  for (i = 0; i < ST_STREAM_N; i++)
+    num += (stream_a[i] - mean_a) * (stream_b[i] - mean_b);
+
+  stream_ref[0] = sum_a;
+  stream_ref[1] = sum_b;
+  stream_ref[2] = mean_a;
+  stream_ref[3] = mean_b;
+  stream_ref[4] = var_a / ST_STREAM_N;
+  stream_ref[5] = var_b / ST_STREAM_N;
+  stream_ref[6] = sqrt (var_a / ST_STREAM_N);
+  stream_ref[7] = sqrt (var_b / ST_STREAM_N);
+  stream_ref[8] = num / (sqrt (var_a) * sqrt (var_b));
+
+  st_stream_errors = 0;
+  st_stream_executions = 0;
+}
+
+
+static int st_stream_benchmark_body (int  rpt);
+
+void
+st_stream_warm_caches (int  heat)
+{
+  int  res = st_stream_benchmark_body (heat);
+
+  return;
+}
+
+
+void
+st_stream_benchmark (void)
+{
+  for (unsigned int i = 0; i < STREAM_EXECUTIONS; i++)
+  {
+    st_stream_executions++;
+    /* Execute once and check if different of correct */
+    if(st_stream_verify_benchmark(st_stream_benchmark_body(1)) != 1)
+    {
+      st_stream_errors++;
+      log_error_event("st-stream", st_stream_errors, st_stream_executions, " stats=0x%03x", stream_bad, 0);
+    }
+  }
+}
+
+
+static void __attribute__ ((noinline))
+st_stream_pass (void)
+{
+  double n = 0.0, mean_a = 0.0, mean_b = 0.0;
+  double m2_a = 0.0, m2_b = 0.0, c_ab = 0.0;
+  int i0;
+
+  for (i0 = 0; i0 < ST_STREAM_N; i0 += ST_STREAM_BLOCK)
+    {
+      const double *a = stream_a + i0, *b = stream_b + i0;
+      int len = ST_STREAM_N - i0 < ST_STREAM_BLOCK ?
+	ST_STREAM_N - i0 : ST_STREAM_BLOCK;
+      double sa = 0.0, sb = 0.0, qa = 0.0, qb = 0.0, qab = 0.0;
+      double ma, mb, da, db, nb = len, nn;
+      int i;
+
+      /* Slice statistics, the slice stays in cache between the loops */
+      for (i = 0; i < len; i++)
+	{
+	  sa += a[i];
+	  sb += b[i];
+	}
+      ma = sa / nb;
+      mb = sb / nb;
+
+      for (i = 0; i < len; i++)
+	{
+	  double xa = a[i] - ma, xb = b[i] - mb;
+
+	  qa += xa * xa;
+	  qb += xb * xb;
+	  qab += xa * xb;
+	}
+
+      /* Merge into the running totals */
+      nn = n + nb;
+      da = ma - mean_a;
+      db = mb - mean_b;
+      mean_a += da * nb / nn;
+      mean_b += db * nb / nn;
+      m2_a += qa + da * da * n * nb / nn;
+      m2_b += qb + db * db * n * nb / nn;
+      c_ab += qab + da * db * n * nb / nn;
+      n = nn;
+    }
+
+  stream_res[0] = mean_a * n;
+  stream_res[1] = mean_b * n;
+  stream_res[2] = mean_a;
+  stream_res[3] = mean_b;
+  stream_res[4] = m2_a / n;
+  stream_res[5] = m2_b / n;
+  stream_res[6] = sqrt (m2_a / n);
+  stream_res[7] = sqrt (m2_b / n);
+  stream_res[8] = c_ab / (sqrt (m2_a) * sqrt (m2_b));
+}
+
+
+/* Returns the number of statistics outside the tolerance */
+
+static int __attribute__ ((noinline))
+st_stream_benchmark_body (int rpt)
+{
+  int errors = 0;
+  int i, k;
+
+  for (i = 0; i < rpt; i++)
+    {
+      st_stream_pass ();
+
+      errors = 0;
+      stream_bad = 0;
+      for (k = 0; k < ST_STREAM_STATS; k++)
+	if (!(fabs (stream_res[k] - stream_ref[k])
+	      <= ST_STREAM_TOL * fabs (stream_ref[k])))
+	  {
+	    errors++;
+	    stream_bad |= 1U << k;
+	  }
+    }
+
+  return errors;
+}
+
+int
+st_stream_verify_benchmark (int r)
+{
+  return 0 == r;
+}
+
+unsigned int
+st_stream_get_errors (void)
+{
+  return st_stream_errors;
+}
+
+unsigned int
+st_stream_get_executions (void)
+{
+  return st_stream_executions;
+}
+
+
 /*
    Local Variables:
    mode: C
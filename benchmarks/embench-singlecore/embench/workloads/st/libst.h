@@ -42,6 +42,14 @@ int st_verify_benchmark(int res);
 unsigned int st_get_errors(void);
 unsigned int st_get_executions(void);
 
+/* Single-pass streaming variant (st-stream workload) */
+void st_stream_initialise_benchmark(void);
+void st_stream_warm_caches(int temperature);
+void st_stream_benchmark(void) __attribute__ ((noinline));
+int st_stream_verify_benchmark(int res);
+unsigned int st_stream_get_errors(void);
+unsigned int st_stream_get_executions(void);
+
 /* Local simplified versions of library functions */
 
 #endif /* LIBST_H */
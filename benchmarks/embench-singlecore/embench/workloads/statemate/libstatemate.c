@@ -1462,7 +1462,7 @@ statemate_benchmark (void)
     if(statemate_verify_benchmark(statemate_benchmark_body(1)) != 1)
     {
       statemate_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] statemate: errnum=%u itr=%u\n", statemate_errors, statemate_executions);
+      log_error_event("statemate", statemate_errors, statemate_executions, NULL, 0, 0);
     }
   }
 }
@@ -89,22 +89,47 @@
 #include "inc/common.h"
 #include <embench/support.h>
 
+/* Order of the system.  0 runs the original 6x6 kernel, otherwise a blocked
+   LU factorisation of a UD_N x UD_N system modulo 2^31 - 1. */
+#ifndef UD_N
+#define UD_N 0
+#endif
+
 /* This scale factor will be changed to equalise the runtime of the
    benchmarks. */
 #ifdef IS_SIMULATION
 #define LOCAL_SCALE_FACTOR 15
+#elif UD_N > 0
+/* Calibrated for UD_N = 32, larger systems run fewer executions */
+#define LOCAL_SCALE_FACTOR 2
+#define NUMBER_OF_EXECUTIONS \
+  ((LOCAL_SCALE_FACTOR * CPU_MHZ * 32 * 32 * 32) / (UD_N * UD_N * UD_N))
 #else
 #define LOCAL_SCALE_FACTOR 333
 #define NUMBER_OF_EXECUTIONS  (LOCAL_SCALE_FACTOR * CPU_MHZ)
 #endif
 
 #include <stdio.h>
+#include <stdint.h>
 unsigned int ud_errors;
 unsigned int ud_executions; 
 
+/* RANDOM_INPUTS needs the residual check of the blocked mode, the 6x6
+   kernel divides with truncation and keeps its fixed system */
+#define UD_RANDOM ((RANDOM_INPUTS == 1) && (UD_N > 0))
+
+#if UD_RANDOM
+/* One word per draw, the hash key of A and b */
+static uint32_t ud_rng;
+static uint32_t ud_seed;
+static unsigned int ud_left;
+#endif
+
+#if UD_N == 0
 long int a[20][20], b[20], x[20];
 
 int ludcmp(int nmax, int n);
+#endif
 
 
 /*  static double fabs(double n) */
@@ -123,18 +148,28 @@ volatile int chkerr;
 int
 ud_verify_benchmark (int res)
 {
+#if UD_N > 0
+  /* Zero pivots and rows with a non-zero residual */
+  return 0 == res;
+#else
   long int x_ref[20] =
     { 0L, 0L, 1L, 1L, 1L, 2L, 0L, 0L, 0L, 0L,
       0L, 0L, 0L, 0L, 0L, 0L, 0L, 0L, 0L, 0L
     };
 
   return (0 == memcmp (x, x_ref, 20 * sizeof (x[0]))) && (0 == res);
+#endif
 }
 
 
 void
 ud_initialise_benchmark (void)
 {
+#if UD_RANDOM
+  if (0 == ud_rng)
+    ud_rng = 0x75645f6eU;
+  ud_left = 0;
+#endif
   ud_errors = 0;
   ud_executions = 0;
 }
@@ -161,12 +196,18 @@ ud_benchmark (void)
     if(ud_verify_benchmark(ud_benchmark_body(1)) != 1)
     {
       ud_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] ud: errnum=%u itr=%u\n", ud_errors, ud_executions);
+#if UD_RANDOM
+      ud_left = 0;
+      log_error_event("ud", ud_errors, ud_executions, " seed=0x%08x", ud_seed, 0);
+#else
+      log_error_event("ud", ud_errors, ud_executions, NULL, 0, 0);
+#endif
     }
   }
 }
 
 
+#if UD_N == 0
 static int __attribute__ ((noinline))
 ud_benchmark_body (int rpt)
 {
@@ -245,6 +286,218 @@ int ludcmp(int nmax, int n)
     }
   return(0);
 }
+#else
+
+/* Blocked LU.
+
+   The system is solved modulo the Mersenne prime 2^31 - 1, so the integer
+   factorisation is exact and the solution is checked by a zero residual
+   A x - b instead of a stored reference.  A and b are hashed from their
+   indices and a key, only the factors are kept in memory.  With
+   RANDOM_INPUTS the key is drawn from a stream. */
+
+#ifndef UD_NB
+#define UD_NB 8			/* Panel width and update tile */
+#endif
+
+#define UD_P 0x7fffffffU
+
+static uint32_t ud_lu[UD_N][UD_N];
+static uint32_t ud_x[UD_N];
+
+/* Hash key of the system, drawn from a stream with RANDOM_INPUTS */
+static uint32_t ud_key = 0x9e3779b9U;
+
+static uint32_t
+ud_reduce (uint64_t v)
+{
+  v = (v & UD_P) + (v >> 31);
+  v = (v & UD_P) + (v >> 31);
+  return v >= UD_P ? v - UD_P : v;
+}
+
+static uint32_t
+ud_mul (uint32_t a, uint32_t b)
+{
+  return ud_reduce ((uint64_t) a * b);
+}
+
+static uint32_t
+ud_sub (uint32_t a, uint32_t b)
+{
+  return a >= b ? a - b : a + UD_P - b;
+}
+
+/* a^(p - 2) */
+
+static uint32_t
+ud_inverse (uint32_t a)
+{
+  uint32_t r = 1, e = UD_P - 2;
+
+  while (e)
+    {
+      if (e & 1)
+	r = ud_mul (r, a);
+      a = ud_mul (a, a);
+      e >>= 1;
+    }
+
+  return r;
+}
+
+/* A[row][col] for col < UD_N, b[row] for col == UD_N */
+
+static uint32_t
+ud_entry (int row, int col)
+{
+  uint32_t h = (uint32_t) (row * (UD_N + 1) + col) + ud_key;
+
+  h ^= h >> 16;
+  h *= 0x7feb352dU;
+  h ^= h >> 15;
+  h *= 0x846ca68bU;
+  h ^= h >> 16;
+
+  return h % UD_P;
+}
+
+/* Right-looking LU without pivoting, returns 1 on a zero pivot */
+
+static int
+ud_factor (void)
+{
+  int k0, k1, ii, jj, i, j, k;
+
+  for (k0 = 0; k0 < UD_N; k0 = k1)
+    {
+      k1 = k0 + UD_NB < UD_N ? k0 + UD_NB : UD_N;
+
+      /* Panel, columns k0 to k1 - 1 */
+      for (k = k0; k < k1; k++)
+	{
+	  uint32_t inv;
+
+	  if (0 == ud_lu[k][k])
+	    return 1;
+	  inv = ud_inverse (ud_lu[k][k]);
+
+	  for (i = k + 1; i < UD_N; i++)
+	    {
+	      uint32_t l = ud_mul (ud_lu[i][k], inv);
+
+	      ud_lu[i][k] = l;
+	      for (j = k + 1; j < k1; j++)
+		ud_lu[i][j] = ud_sub (ud_lu[i][j], ud_mul (l, ud_lu[k][j]));
+	    }
+	}
+
+      /* Block row of U */
+      for (k = k0; k < k1; k++)
+	for (i = k + 1; i < k1; i++)
+	  for (j = k1; j < UD_N; j++)
+	    ud_lu[i][j] = ud_sub (ud_lu[i][j], ud_mul (ud_lu[i][k], ud_lu[k][j]));
+
+      /* Trailing update, one tile at a time */
+      for (ii = k1; ii < UD_N; ii += UD_NB)
+	for (jj = k1; jj < UD_N; jj += UD_NB)
+	  {
+	    int i1 = ii + UD_NB < UD_N ? ii + UD_NB : UD_N;
+	    int j1 = jj + UD_NB < UD_N ? jj + UD_NB : UD_N;
+
+	    for (i = ii; i < i1; i++)
+	      for (j = jj; j < j1; j++)
+		{
+		  uint64_t acc = 0;
+
+		  for (k = k0; k < k1; k++)
+		    {
+		      acc += (uint64_t) ud_lu[i][k] * ud_lu[k][j];
+		      acc = (acc & UD_P) + (acc >> 31);
+		    }
+		  ud_lu[i][j] = ud_sub (ud_lu[i][j], ud_reduce (acc));
+		}
+	  }
+    }
+
+  return 0;
+}
+
+/* Returns the number of rows of A x - b that are not zero, or -1 on a zero
+   pivot */
+
+static int __attribute__ ((noinline))
+ud_benchmark_body (int rpt)
+{
+  int bad = 0;
+  int k;
+
+  for (k = 0; k < rpt; k++)
+    {
+      int i, j;
+
+#if UD_RANDOM
+      if (0 == ud_left)
+	{
+	  ud_seed = ud_rng;
+	  ud_key = xorshift32_beebs (&ud_rng);
+	  ud_left = RANDOM_INPUTS_PERIOD;
+	}
+      ud_left--;
+#endif
+      for (i = 0; i < UD_N; i++)
+	for (j = 0; j < UD_N; j++)
+	  ud_lu[i][j] = ud_entry (i, j);
+
+      if (ud_factor ())
+	{
+#if UD_RANDOM
+	  /* About UD_N in 2^31 drawn systems need pivoting, not an error */
+	  bad = 0;
+#else
+	  bad = -1;
+#endif
+	  continue;
+	}
+
+      /* L y = b, y is built in x */
+      for (i = 0; i < UD_N; i++)
+	{
+	  uint32_t w = ud_entry (i, UD_N);
+
+	  for (j = 0; j < i; j++)
+	    w = ud_sub (w, ud_mul (ud_lu[i][j], ud_x[j]));
+	  ud_x[i] = w;
+	}
+
+      /* U x = y */
+      for (i = UD_N - 1; i >= 0; i--)
+	{
+	  uint32_t w = ud_x[i];
+
+	  for (j = i + 1; j < UD_N; j++)
+	    w = ud_sub (w, ud_mul (ud_lu[i][j], ud_x[j]));
+	  ud_x[i] = ud_mul (w, ud_inverse (ud_lu[i][i]));
+	}
+
+      /* Residual against A and b hashed again */
+      bad = 0;
+      for (i = 0; i < UD_N; i++)
+	{
+	  uint64_t acc = 0;
+
+	  for (j = 0; j < UD_N; j++)
+	    {
+	      acc += (uint64_t) ud_entry (i, j) * ud_x[j];
+	      acc = (acc & UD_P) + (acc >> 31);
+	    }
+	  bad += ud_reduce (acc) != ud_entry (i, UD_N);
+	}
+    }
+
+  return bad;
+}
+#endif
 
 unsigned int
 ud_get_errors (void)
@@ -37,6 +37,19 @@
 
 unsigned int wikisort_errors;
 unsigned int wikisort_executions; 
+unsigned int wikisort_par_errors;
+unsigned int wikisort_par_executions;
+
+/* Partitioned variant (wikisort-par workload): WIKISORT_PAR_SIZE items are
+   split into WIKISORT_PAR_PARTS partitions sorted with WikiSort, then merged
+   pairwise with merge-path, each merge round split into WIKISORT_PAR_PARTS
+   equal slices of the output. */
+#ifndef WIKISORT_PAR_SIZE
+#define WIKISORT_PAR_SIZE 400
+#endif
+#ifndef WIKISORT_PAR_PARTS
+#define WIKISORT_PAR_PARTS 4
+#endif
 
 /* various #defines for the C code */
 #ifndef true
@@ -953,12 +966,69 @@ TestingMostlyEqual (long index, long total)
 const long max_size = 400;
 Test array1[400];
 
+#if (RANDOM_INPUTS == 1)
+/* One word per draw, the rand_beebs () seed of the test cases */
+static uint32_t wikisort_rng;
+static uint32_t wikisort_seed;
+static unsigned int wikisort_left;
+static uint32_t wikisort_key;
+
+/* Test cases that failed wikisort_check () in the last execution, by bit.
+   Every test case is checked in the first execution checked after a draw,
+   and its result is kept once they have all passed. The other executions
+   compare their result with it, as for the fixed seed. */
+static uint32_t wikisort_bad;
+static Test wikisort_expect[400];
+static int wikisort_kept;
+
+/* Value given to each item of the test case being checked, by index */
+static long wikisort_input[400];
+
+/* Returns nonzero unless array1 holds the items of the current test case
+   in stable order. (value, index) must increase strictly and each item
+   must carry the value its index was given, so every index is present
+   exactly once. */
+static int
+wikisort_check (long total)
+{
+  long i;
+
+  for (i = 0; i < total; i++)
+    {
+      long index = array1[i].index;
+
+      if (index < 0 || index >= total
+	  || array1[i].value != wikisort_input[index])
+	return 1;
+      if (i > 0
+	  && (array1[i - 1].value > array1[i].value
+	      || (array1[i - 1].value == array1[i].value
+		  && array1[i - 1].index >= index)))
+	return 1;
+    }
+
+  return 0;
+}
+#endif
+
 
 /* This benchmark does not support verification */
 
 int
 wikisort_verify_benchmark (int res __attribute ((unused)))
 {
+#if (RANDOM_INPUTS == 1)
+  if (!wikisort_kept)
+    {
+      if (0 != res)
+	return 0;
+      memcpy (wikisort_expect, array1, sizeof (wikisort_expect));
+      wikisort_kept = 1;
+      return 1;
+    }
+
+  return 0 == memcmp (array1, wikisort_expect, sizeof (wikisort_expect));
+#else
   Test exp[] = {
     {1000, 1}, {1000, 2}, {1000, 13}, {1000, 18}, {1000, 19},
     {1000, 26}, {1000, 31}, {1000, 32}, {1000, 35}, {1000, 36},
@@ -1043,12 +1113,18 @@ wikisort_verify_benchmark (int res __attribute ((unused)))
   };
 
   return 0 == memcmp (array1, exp, max_size * sizeof (array1[0]));
+#endif
 }
 
 
 void
 wikisort_initialise_benchmark (void)
 {
+#if (RANDOM_INPUTS == 1)
+  if (0 == wikisort_rng)
+    wikisort_rng = 0x77696b69U;
+  wikisort_left = 0;
+#endif
   wikisort_errors = 0;
   wikisort_executions = 0;
 }
@@ -1075,7 +1151,12 @@ wikisort_benchmark (void)
     if(wikisort_verify_benchmark(wikisort_benchmark_body(1)) != 1)
     {
       wikisort_errors++;
-      log_from_moncore_noheader_nospinlock("\n[BENCHMARK_ERROR] wikisort: errnum=%u itr=%u\n", wikisort_errors, wikisort_executions);
+#if (RANDOM_INPUTS == 1)
+      wikisort_left = 0;
+      log_error_event("wikisort", wikisort_errors, wikisort_executions, " seed=0x%08x cases=0x%03x", wikisort_seed, wikisort_bad);
+#else
+      log_error_event("wikisort", wikisort_errors, wikisort_executions, NULL, 0, 0);
+#endif
     }
   }
 }
@@ -1086,6 +1167,10 @@ wikisort_benchmark_body (int rpt)
 {
   long total, index, test_case;
   Comparison compare = TestCompare;
+  int bad = 0;
+#if (RANDOM_INPUTS == 1)
+  int checked;
+#endif
 
   TestCasePtr test_cases[9] =
   {
@@ -1104,7 +1189,20 @@ wikisort_benchmark_body (int rpt)
       /* initialize the random-number generator. */
       /* The original code used srand here, we use a value that will fit in
          a 16-bit unsigned int. */
+#if (RANDOM_INPUTS == 1)
+      if (0 == wikisort_left)
+	{
+	  wikisort_seed = wikisort_rng;
+	  wikisort_key = xorshift32_beebs (&wikisort_rng);
+	  wikisort_left = RANDOM_INPUTS_PERIOD;
+	  wikisort_kept = 0;
+	}
+      wikisort_left--;
+      checked = !wikisort_kept;
+      srand_beebs (wikisort_key);
+#else
       srand_beebs (0);
+#endif
       /*srand(10141985); *//* in case you want the same random numbers */
 
       total = max_size;
@@ -1119,13 +1217,25 @@ wikisort_benchmark_body (int rpt)
 	      item.index = index;
 
 	      array1[index] = item;
+#if (RANDOM_INPUTS == 1)
+	      if (checked)
+		wikisort_input[index] = item.value;
+#endif
 	    }
 
 	  WikiSort (array1, total, compare);
+#if (RANDOM_INPUTS == 1)
+	  if (checked)
+	    bad |= wikisort_check (total) << test_case;
+#endif
 	}
     }
 
-  return 0;
+#if (RANDOM_INPUTS == 1)
+  wikisort_bad = bad;
+#endif
+  /* Test cases that failed wikisort_check (), by bit */
+  return bad;
 }
 
 unsigned int
@@ -1141,6 +1251,242 @@ wikisort_get_executions (void)
 }
 
 
+// Partitioned merge sort variant
+
+/* Ping-pong buffers for the merge rounds */
+static Test par_array[2][WIKISORT_PAR_SIZE];
+
+/* Index of the buffer holding the sorted output */
+static int par_result;
+
+/* Start of partition part, WIKISORT_PAR_PARTS gives the end of the array */
+static long
+par_bound (long part)
+{
+  return WIKISORT_PAR_SIZE * Min (part, WIKISORT_PAR_PARTS) / WIKISORT_PAR_PARTS;
+}
+
+/* Order-independent checksum of the (value, index) pairs, so that a
+   permutation of the input keeps it and a lost or duplicated item does not */
+static uint64_t
+par_checksum (const Test array[], long size)
+{
+  uint64_t sum = 0, mix = 0;
+  long i;
+
+  for (i = 0; i < size; i++)
+    {
+      uint64_t h = ((uint64_t) (uint32_t) array[i].value << 32)
+	| (uint32_t) array[i].index;
+
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      sum += h;
+      mix ^= h;
+    }
+
+  return sum ^ (mix << 1);
+}
+
+/* Sorts partition part of the input in place. Partitions are disjoint, so
+   each one can be sorted by a different hart. */
+void
+wikisort_par_sort_part (long part)
+{
+  const long start = par_bound (part);
+
+  WikiSort (&par_array[0][start], par_bound (part + 1) - start, TestCompare);
+}
+
+/* Merge-path split: number of items taken from A among the first diag
+   items of the stable merge of A and B */
+static long
+par_merge_split (const Test A[], long A_len, const Test B[], long B_len,
+		 long diag)
+{
+  long lo = Max (0, diag - B_len);
+  long hi = Min (diag, A_len);
+
+  while (lo < hi)
+    {
+      long mid = lo + (hi - lo) / 2;
+
+      /* Equal items come from A first, which keeps the merge stable */
+      if (!TestCompare (B[diag - mid - 1], A[mid]))
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  return lo;
+}
+
+/* Writes items [out_start, out_end) of the merge of src A and B to dst */
+static void
+par_merge_slice (const Test src[], Test dst[], Range A, Range B,
+		 long out_start, long out_end)
+{
+  long diag = out_start - A.start;
+  long a = par_merge_split (&src[A.start], Range_length (A),
+			    &src[B.start], Range_length (B), diag);
+  long b = B.start + diag - a;
+  long out;
+
+  a += A.start;
+  for (out = out_start; out < out_end; out++)
+    {
+      if (a < A.end && (b >= B.end || !TestCompare (src[b], src[a])))
+	dst[out] = src[a++];
+      else
+	dst[out] = src[b++];
+    }
+}
+
+/* Merge round round: runs of 2^round partitions are merged pairwise from
+   par_array[round & 1] into the other buffer. Slice slice of the output is
+   independent of the other slices. */
+void
+wikisort_par_merge_slice (int round, long slice)
+{
+  const Test *src = par_array[round & 1];
+  Test *dst = par_array[(round + 1) & 1];
+  const long width = 1L << round;
+  const long out_start = par_bound (slice);
+  const long out_end = par_bound (slice + 1);
+  long pair;
+
+  for (pair = 0; pair * 2 * width < WIKISORT_PAR_PARTS; pair++)
+    {
+      Range A = MakeRange (par_bound (pair * 2 * width),
+			   par_bound ((pair * 2 + 1) * width));
+      Range B = MakeRange (A.end, par_bound ((pair * 2 + 2) * width));
+
+      if (B.end <= out_start || A.start >= out_end)
+	continue;
+
+      par_merge_slice (src, dst, A, B, Max (A.start, out_start),
+		       Min (B.end, out_end));
+    }
+}
+
+/* Checks the merged output is stably sorted and a permutation of the
+   input with the given checksum */
+static int
+par_check (const Test array[], uint64_t checksum)
+{
+  long i;
+
+  for (i = 1; i < WIKISORT_PAR_SIZE; i++)
+    {
+      if (TestCompare (array[i], array[i - 1]))
+	return 0;
+      if (array[i].value == array[i - 1].value
+	  && array[i].index < array[i - 1].index)
+	return 0;
+    }
+
+  return par_checksum (array, WIKISORT_PAR_SIZE) == checksum;
+}
+
+void
+wikisort_par_initialise_benchmark (void)
+{
+  wikisort_par_errors = 0;
+  wikisort_par_executions = 0;
+}
+
+static int __attribute__ ((noinline))
+wikisort_par_benchmark_body (int rpt)
+{
+  TestCasePtr test_cases[9] =
+  {
+  &TestingPathological,
+      &TestingRandom,
+      &TestingMostlyDescending,
+      &TestingMostlyAscending,
+      &TestingAscending,
+      &TestingDescending,
+      &TestingEqual, &TestingJittered, &TestingMostlyEqual};
+  long index, part, test_case;
+  int failed = 0;
+  int i, round;
+
+  for (i = 0; i < rpt; i++)
+    {
+      srand_beebs (0);
+      failed = 0;
+
+      for (test_case = 0; test_case < 9; test_case++)
+	{
+	  uint64_t checksum;
+
+	  for (index = 0; index < WIKISORT_PAR_SIZE; index++)
+	    {
+	      par_array[0][index].value =
+		test_cases[test_case] (index, WIKISORT_PAR_SIZE);
+	      par_array[0][index].index = index;
+	    }
+	  checksum = par_checksum (par_array[0], WIKISORT_PAR_SIZE);
+
+	  for (part = 0; part < WIKISORT_PAR_PARTS; part++)
+	    wikisort_par_sort_part (part);
+
+	  for (round = 0; (1L << round) < WIKISORT_PAR_PARTS; round++)
+	    for (part = 0; part < WIKISORT_PAR_PARTS; part++)
+	      wikisort_par_merge_slice (round, part);
+	  par_result = round & 1;
+
+	  if (!par_check (par_array[par_result], checksum))
+	    failed++;
+	}
+    }
+
+  return failed;
+}
+
+void
+wikisort_par_warm_caches (int heat)
+{
+  int res = wikisort_par_benchmark_body (heat);
+
+  return;
+}
+
+int
+wikisort_par_verify_benchmark (int res)
+{
+  return 0 == res;
+}
+
+void
+wikisort_par_benchmark (void)
+{
+  for (unsigned int i = 0; i < NUMBER_OF_EXECUTIONS; i++)
+  {
+    wikisort_par_executions++;
+    /* Execute once and check if different of correct */
+    if(wikisort_par_verify_benchmark(wikisort_par_benchmark_body(1)) != 1)
+    {
+      wikisort_par_errors++;
+      log_error_event("wikisort-par", wikisort_par_errors, wikisort_par_executions, NULL, 0, 0);
+    }
+  }
+}
+
+unsigned int
+wikisort_par_get_errors (void)
+{
+  return wikisort_par_errors;
+}
+
+unsigned int
+wikisort_par_get_executions (void)
+{
+  return wikisort_par_executions;
+}
+
+
 /*
    Local Variables:
    mode: C
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ *
+ * Hardware error counters: L2 cache ECC and bus error units (HWERR_COLLECT == 1)
+ *
+ * hwerr_collect() is called at each cycle boundary and returns what changed
+ * since the previous call, one entry per source:
+ *   - l2_dir, l2_data: L2 directory/data ECC corrected (fix) and uncorrected
+ *     (fail) counters, with the address of the last error.
+ *   - beu_hN: bus error unit of hart N. It has no counters: the cause and value
+ *     (address) of the first event are latched and every enabled event type sets
+ *     a bit in accrued. A unit is reported when its cause changes or accrued gains
+ *     bits; correctable (2, 6) and uncorrectable (3, 7) ECC bits are counted once
+ *     each, a TileLink bus error (5) only shows in the cause. Only the calling
+ *     hart's unit is armed and cleared after reading, the others are read as they
+ *     are (their harts, e.g. HART0 for [ERROR], own the clearing).
+ *   - Linux: every EDAC device or memory controller found under
+ *     /sys/devices/system/edac with ce_count/ue_count, named by its path there.
+ *
+ * The first call gives the counts since reset (or boot).
+ *
+ */
+
+#ifndef HWERR_H_
+#define HWERR_H_
+
+#include <stdint.h>
+
+#define HWERR_SOURCES           8       /* largest number of sources in one collection */
+
+/* BEU cause values */
+#define HWERR_BEU_ICACHE_CE     2       /* instruction cache / ITIM correctable ECC    */
+#define HWERR_BEU_ITIM_UE       3       /* ITIM uncorrectable ECC                      */
+#define HWERR_BEU_TILELINK      5       /* load/store/PTW TileLink bus error           */
+#define HWERR_BEU_DCACHE_CE     6       /* data cache correctable ECC                  */
+#define HWERR_BEU_DCACHE_UE     7       /* data cache uncorrectable ECC                */
+
+typedef struct
+{
+    const char *name;
+    uint32_t corrected;                 /* new corrected errors                        */
+    uint32_t uncorrected;               /* new uncorrected errors                      */
+    uint32_t cause;                     /* BEU: cause of the first event, 0 otherwise  */
+    uint64_t addr;                      /* L2: last error address, BEU: value          */
+} hwerr_delta_t;
+
+/**
+ * functions
+ */
+void hwerr_init(void);
+uint8_t hwerr_collect(hwerr_delta_t *delta, uint8_t max);
+
+#endif /* HWERR_H_ */
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ *
+ * Compact binary records for the UART log (LOG_BINARY == 1)
+ *
+ * A record is a tag byte, a payload of LEB128 varints/strings and a CRC-16
+ * (CCITT-FALSE, big-endian) over both. On the wire it is sent as one line:
+ *
+ *     0x00 | COBS(record) ^ 0x0A | 0x0A
+ *
+ * COBS is applied to remove zeros and the result is XORed with 0x0A, which
+ * moves the only absent byte value to the newline. The host FPGA therefore
+ * still adds one timestamp per record, and text lines can share the link:
+ * a line that starts with 0x00 is a record, anything else is text.
+ *
+ */
+
+#ifndef LOGBIN_H_
+#define LOGBIN_H_
+
+#include <stdint.h>
+
+/* Tag byte: record type in the upper 5 bits, source hart in the lower 3 */
+#define LOGBIN_TAG(type, hart)      (uint8_t)(((type) << 3) | ((hart) & 0x7))
+
+/* Record types */
+#define LOGBIN_LIFECYCLE            1   /* marker, then the marker argument if any        */
+#define LOGBIN_RESULTS              2   /* cycle, n, errors[n], execs[n], runtime[n], crc */
+#define LOGBIN_ERROR                3   /* name, errnum, itr, extra text                  */
+#define LOGBIN_TVS                  4   /* 1v0, 1v8, 2v5 mV, temp C signed; empty: failed */
+#define LOGBIN_TRACE                5   /* format ID << 1 | hart header, raw arguments    */
+#define LOGBIN_RESULTS_DELTA        6   /* cycle, n, crc, 3x (count, count x (i, value))  */
+#define LOGBIN_TVS_STATS            7   /* samples, failed, [4x (min, mean, max)],        */
+                                        /* crossings, [channel, value, mcycle]            */
+#define LOGBIN_HWERR                8   /* n, n x (name, corrected, uncorrected, cause,    */
+                                        /* addr); corrected/uncorrected since last record */
+
+/* Lifecycle markers */
+#define LOGBIN_MARK_INIT            0   /* [INIT_HARTn]                                   */
+#define LOGBIN_MARK_CYCLE_START     1   /* [BENCHMARK_START] run_cycle: cycle             */
+#define LOGBIN_MARK_SCHEDULER       2   /* [FREERTOS] Start scheduler                     */
+#define LOGBIN_MARK_TASK_START      3   /* [FREERTOS] Start of: name                      */
+#define LOGBIN_MARK_TASK_END        4   /* [FREERTOS] End of: name                        */
+
+/* Largest record (tag + payload + CRC) and its worst case size on the wire */
+#define LOGBIN_RECORD_SIZE          512
+#define LOGBIN_WIRE_SIZE            (LOGBIN_RECORD_SIZE + LOGBIN_RECORD_SIZE / 254 + 3)
+
+typedef struct
+{
+    uint8_t buf[LOGBIN_RECORD_SIZE];
+    uint16_t len;
+    uint8_t overflow;
+} logbin_record_t;
+
+/**
+ * functions
+ */
+void logbin_begin(logbin_record_t *rec, uint8_t type, uint8_t hart);
+void logbin_put_uint(logbin_record_t *rec, uint32_t value);
+void logbin_put_int(logbin_record_t *rec, int32_t value);
+void logbin_put_str(logbin_record_t *rec, const char *str);
+void logbin_put_int64(logbin_record_t *rec, int64_t value);
+void logbin_put_double(logbin_record_t *rec, double value);
+void logbin_put_ptr(logbin_record_t *rec, const void *ptr);
+uint32_t logbin_crc32(uint32_t crc, const uint32_t *words, uint32_t count);
+uint16_t logbin_frame(logbin_record_t *rec, uint8_t *wire);
+
+/* Trace arguments (LOG_DEFERRED): the C type picks the encoding - strings are copied,
+ * floating point is sent as the 8 raw bytes of a double and everything else as a
+ * zigzag varint. The host reads them back in the order of the format conversions. */
+#define LOGBIN_PUT_ARG(rec, x)                                          \
+    _Generic((x),                                                       \
+        char *: logbin_put_str, const char *: logbin_put_str,           \
+        void *: logbin_put_ptr, const void *: logbin_put_ptr,           \
+        float: logbin_put_double, double: logbin_put_double,            \
+        default: logbin_put_int64)((rec), (x))
+
+#define LOGBIN_NARGS(...)           LOGBIN_NARGS_(0, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOGBIN_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, n, ...) n
+#define LOGBIN_CAT(a, b)            LOGBIN_CAT_(a, b)
+#define LOGBIN_CAT_(a, b)           a##b
+
+/* Up to 12 arguments */
+#define LOGBIN_PUT_ARGS(rec, ...)   LOGBIN_CAT(LOGBIN_PUT_, LOGBIN_NARGS(__VA_ARGS__))(rec, ##__VA_ARGS__)
+#define LOGBIN_PUT_0(rec)
+#define LOGBIN_PUT_1(rec, a)        LOGBIN_PUT_ARG(rec, a)
+#define LOGBIN_PUT_2(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_1(rec, __VA_ARGS__)
+#define LOGBIN_PUT_3(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_2(rec, __VA_ARGS__)
+#define LOGBIN_PUT_4(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_3(rec, __VA_ARGS__)
+#define LOGBIN_PUT_5(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_4(rec, __VA_ARGS__)
+#define LOGBIN_PUT_6(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_5(rec, __VA_ARGS__)
+#define LOGBIN_PUT_7(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_6(rec, __VA_ARGS__)
+#define LOGBIN_PUT_8(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_7(rec, __VA_ARGS__)
+#define LOGBIN_PUT_9(rec, a, ...)   LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_8(rec, __VA_ARGS__)
+#define LOGBIN_PUT_10(rec, a, ...)  LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_9(rec, __VA_ARGS__)
+#define LOGBIN_PUT_11(rec, a, ...)  LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_10(rec, __VA_ARGS__)
+#define LOGBIN_PUT_12(rec, a, ...)  LOGBIN_PUT_ARG(rec, a); LOGBIN_PUT_11(rec, __VA_ARGS__)
+
+#endif /* LOGBIN_H_ */
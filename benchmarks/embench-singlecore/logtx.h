@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *
+ * Asynchronous UART transmit queue for the log (LOG_TX_ASYNC == 1)
+ *
+ * Writers copy their bytes into a ring and return. logtx_poll() hands the oldest
+ * contiguous part of the ring to the port and, once it has gone out, releases it
+ * and calls the completion callbacks of the writes it contained. Nothing here
+ * waits for the link unless the ring is full.
+ *
+ * Ports:
+ *   - MMUART: MSS_UART_irq_tx(), the HAL interrupt handler refills the TX FIFO.
+ *     The MMUART interrupt must be enabled in the PLIC of the hart that polls.
+ *   - Linux (stand-in for host runs): a file descriptor in non-blocking mode,
+ *     each poll writes what the descriptor accepts.
+ *
+ * Single writer per queue: queues are only used by the moncore, callers serialise
+ * with mutex_uart0 as for the polled path.
+ *
+ * A write into a full ring (or with LOGTX_PENDING callbacks outstanding) polls
+ * until the port has freed some space, which on the MMUART takes its interrupt:
+ * logtx_write() must be called from thread context with interrupts enabled, never
+ * from an interrupt handler or another critical section.
+ *
+ */
+
+#ifndef LOGTX_H_
+#define LOGTX_H_
+
+#include <stdint.h>
+
+#if defined(__linux__)
+typedef int logtx_port_t;                   /* non-blocking file descriptor */
+#else
+#include "drivers/mss/mss_mmuart/mss_uart.h"
+typedef mss_uart_instance_t *logtx_port_t;
+#endif
+
+#define LOGTX_RING_SIZE             4096    /* bytes, power of two                   */
+#define LOGTX_PENDING               16      /* writes with a callback not yet sent   */
+
+/* Called from logtx_poll() once the bytes of a write have left */
+typedef void (*logtx_done_t)(void *arg);
+
+typedef struct
+{
+    uint32_t end;                           /* ring position after the write */
+    logtx_done_t done;
+    void *arg;
+} logtx_pending_t;
+
+/* One queue per port. Indexes run freely and are masked on access. Ring bytes between
+ * sent and inflight are owned by the port, between inflight and head they wait for the
+ * next poll. A zeroed queue is empty. */
+typedef struct
+{
+    uint32_t head;
+    uint32_t sent;
+    uint32_t inflight;
+    uint32_t pending_head;
+    uint32_t pending_tail;
+    logtx_pending_t pending[LOGTX_PENDING];
+    uint8_t data[LOGTX_RING_SIZE];
+} logtx_queue_t;
+
+/**
+ * functions
+ */
+void logtx_write(logtx_queue_t *queue, logtx_port_t port, const uint8_t *data, uint32_t len, logtx_done_t done, void *arg);
+void logtx_poll(logtx_queue_t *queue, logtx_port_t port);
+
+#endif /* LOGTX_H_ */
@@ -29,10 +29,6 @@ void main(void)
 	HLS_DATA* hls = (HLS_DATA*)(uintptr_t)get_tp_reg();
     HART_SHARED_DATA * hart_share = (HART_SHARED_DATA *)hls->shared_mem;
 
-    /* Temperature/voltage sensors */
-    uint32_t tvs_out0 = 0, tvs_out1 = 0;
-    uint16_t volt_1v0 = 0, volt_1v8 = 0, volt_2v5 = 0, temperature = 0;  
-
 	/* Benchmark variables */
 	uint32_t errors[WORKLOADS] = {0};
 	uint32_t execs[WORKLOADS] = {0};
@@ -63,38 +59,69 @@ void main(void)
     /* (0x862000 - 0x3e8) * ( 1/150MHz/256) = ~15s after system reset */
     MSS_WD_configure(MSS_WDOG1_LO, &wd1lo_config);
 
+#if (TVS_SAMPLER == 1)
+    /* TVS sampling from the machine timer, see SysTick_Handler_h1_IRQHandler() */
+    SysTick_Config();
+    __enable_irq();
+#endif
+
+#if (HWERR_COLLECT == 1)
+    hwerr_init();
+#endif
+
+#if (LOG_BINARY == 1)
+    logbin_record_t rec;
+
+    logbin_begin(&rec, LOGBIN_LIFECYCLE, read_csr(mhartid));
+    logbin_put_uint(&rec, LOGBIN_MARK_INIT);
+    log_record_from_appcore(hart_share, &rec);
+#else
     log_from_appcore_noheader(hart_share, "\n[INIT_HART1]\n\n");
+#endif
 
 	while(1) 
     {
+#if (LOG_BINARY == 1)
+        logbin_begin(&rec, LOGBIN_LIFECYCLE, read_csr(mhartid));
+        logbin_put_uint(&rec, LOGBIN_MARK_CYCLE_START);
+        logbin_put_uint(&rec, run_cycle);
+        log_record_from_appcore(hart_share, &rec);
+#else
         log_from_appcore(hart_share, "[BENCHMARK_START] run_cycle: %d\n", run_cycle);
+#endif
         
         /* Print TVS information */
-        tvs_out0 = MSS_SCBCTRL->TVS_OUTPUT0;
-        tvs_out1 = MSS_SCBCTRL->TVS_OUTPUT1;
-        volt_1v0 = (tvs_out0 & 0x00007FFF) >> 3; 
-        volt_1v8 = (tvs_out0 & 0x7FFF0000) >> 19;
-        volt_2v5 = (tvs_out1 & 0x00007FFF) >> 3;
-        temperature = ((tvs_out1 & 0x7FFF0000) >> 20) - 273;
-        if ((volt_1v0 != 0) || (volt_1v8 != 0) || (volt_2v5 != 0))  
-        {
-            log_from_appcore(hart_share, "[TVS] (volt_1v0 = %umV) (volt_1v8 = %umV) (volt_2v5 = %umV) (temp = %uC)\n\n", 
-                volt_1v0, volt_1v8, volt_2v5, temperature);
-        }  
-        else {
-            log_from_appcore(hart_share, "[TVS] Reading TVS built-in sensor failed\n\n");
-        }
+        log_tvs_from_appcore(hart_share);
             
 		
 		/* Call benchmark suite */
 		run_benchmark(hart_share, errors, execs, runtime, MSS_WDOG1_LO);
         
+#if (HWERR_COLLECT == 1)
+        /* L2 ECC and BEU errors of the cycle */
+        log_hwerr_from_appcore(hart_share);
+#endif
+
         /* Print results */
 		print_results(hart_share, errors, execs, runtime, run_cycle++);
     }
 
 }
 
+#if (TVS_SAMPLER == 1)
+/* HART1 SysTick handler, every HART1_TICK_RATE_MS */
+void SysTick_Handler_h1_IRQHandler(void)
+{
+    static uint32_t ticks = 0;
+
+    if (++ticks >= (TVS_SAMPLE_MS / HART1_TICK_RATE_MS))
+    {
+        ticks = 0;
+        tvs_sample();
+    }
+}
+#endif
+
 /* HART1 Software interrupt handler */
 void Software_h1_IRQHandler(void)
 {
@@ -36,6 +36,8 @@ from queue import Queue
 import re
 import traceback
 import select
+import struct
+import zlib
 
 ########################################################
 # Global variables
@@ -57,6 +59,7 @@ parser.add_argument('--info',      help='board information to be added to the lo
 parser.add_argument('--logdir',    help='log directory to be used', default='')
 #
 parser.add_argument('--output-parser', help='output parser configuration', choices=["current"], default='')
+parser.add_argument('--elf',           help='firmware ELF, needed to decode deferred (LOG_DEFERRED) trace records', default='')
 # debug-only
 parser.add_argument('--enable-user-input', help='enable user input to the UART port', action='store_true', default=False)
 parser.add_argument('--enable-loopback', help='enable loopback test to the UART port', action='store_true', default=False)
@@ -73,6 +76,7 @@ rtscts = args.rtscts
 logdir = args.logdir
 ARG_ENABLE_USER_INPUT = args.enable_user_input
 ARG_OUTPUT_PARSER = args.output_parser
+ARG_ELF = args.elf
 if args.enable_loopback or args.enable_loopback_injected:
     ARG_ENABLE_LOOPBACK = True
 else:
@@ -131,6 +135,286 @@ def parse_output_current(line: str) -> str:
     info_wdt   = f"WDT {COLOR_GOOD}OK{COLOR_NONE}  "  if get_bit(gpio_rdata, GPIO_PIN_SETUP_WDT_WDO) else f"WDT {COLOR_BAD}FAIL{COLOR_NONE}"
     return f"{current_ma:6.2f} mA | {info_pwren} | {info_nrst} | {info_pgood} | {info_wdt}"
 
+########################################################
+# BINARY LOG DECODING
+#
+# Firmware built with LOG_BINARY = 1 (see benchmarks/*/logbin.h) sends results, errors,
+# TVS readings and lifecycle markers as records, one per line:
+#     0x00 | COBS(tag, payload, crc16) ^ 0x0A | 0x0A
+# They are rendered back to the text the firmware prints with LOG_BINARY = 0, so the
+# log files look the same either way. Text lines are passed through untouched.
+# Deferred traces (LOG_DEFERRED = 1) carry an offset into the ELF 'logfmt' section
+# and raw arguments, they are formatted here with the strings read from --elf.
+# Delta results (LOG_RESULTS_KEYFRAME > 0) are applied to the last full results of
+# their hart and printed in full once the CRC-32 of the rebuilt state matches.
+# TVS statistics (TVS_SAMPLER = 1) give the mean on the usual [TVS] line and the rest
+# of the interval (min, max, limit crossings) on a second line.
+# Hardware error counters (HWERR_COLLECT = 1) give one [HWERR] line per source.
+
+LOGBIN_LIFECYCLE = 1
+LOGBIN_RESULTS   = 2
+LOGBIN_ERROR     = 3
+LOGBIN_TVS       = 4
+LOGBIN_TRACE     = 5
+LOGBIN_RESULTS_DELTA = 6
+LOGBIN_TVS_STATS = 7
+LOGBIN_HWERR     = 8
+
+LOGBIN_MARK_INIT        = 0
+LOGBIN_MARK_CYCLE_START = 1
+LOGBIN_MARK_SCHEDULER   = 2
+LOGBIN_MARK_TASK_START  = 3
+LOGBIN_MARK_TASK_END    = 4
+
+TVS_CHANNEL_NAMES = ["volt_1v0", "volt_1v8", "volt_2v5", "temp"]
+
+# timestamp added by the host FPGA at the start of each line
+REGEX_TIMESTAMP = re.compile(rb"^[0-9a-fA-F]{8} ")
+
+class LogbinError(Exception):
+    pass
+
+def logbin_crc16(data: bytes) -> int:
+    # CRC-16/CCITT-FALSE
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def logbin_unframe(data: bytes) -> bytes:
+    # undo the newline XOR, then COBS
+    data = bytes(byte ^ 0x0A for byte in data)
+    record = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise LogbinError("bad COBS block")
+        record += data[i+1:i+code]
+        i += code
+        if code < 0xFF and i < len(data):
+            record.append(0)
+    if len(record) < 3:
+        raise LogbinError("short record")
+    if logbin_crc16(record[:-2]) != int.from_bytes(record[-2:], 'big'):
+        raise LogbinError("CRC mismatch")
+    return bytes(record[:-2])
+
+class LogbinReader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def uint(self) -> int:
+        value = 0
+        for shift in range(0, 70, 7):
+            if self.pos >= len(self.data):
+                raise LogbinError("truncated varint")
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return value
+        raise LogbinError("varint too long")
+
+    def int(self) -> int:
+        value = self.uint()
+        return (value >> 1) ^ -(value & 1)
+
+    def double(self) -> float:
+        if self.pos + 8 > len(self.data):
+            raise LogbinError("truncated double")
+        value = struct.unpack_from('<d', self.data, self.pos)[0]
+        self.pos += 8
+        return value
+
+    def str(self) -> str:
+        length = self.uint()
+        if self.pos + length > len(self.data):
+            raise LogbinError("truncated string")
+        text = self.data[self.pos:self.pos+length].decode('utf-8', errors='replace')
+        self.pos += length
+        return text
+
+def load_logfmt(path: str) -> bytes:
+    """Returns the 'logfmt' section of the firmware ELF: the format strings of deferred traces"""
+    with open(path, 'rb') as elf_file:
+        elf = elf_file.read()
+    if elf[:4] != b'\x7fELF':
+        raise ValueError(f"{path} is not an ELF file")
+    endian = '<' if elf[5] == 1 else '>'
+    if elf[4] == 2:
+        shoff, = struct.unpack_from(endian + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x3A)
+        section = lambda i: struct.unpack_from(endian + 'IIQQQQ', elf, shoff + i * shentsize)
+    else:
+        shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+        section = lambda i: struct.unpack_from(endian + 'IIIIII', elf, shoff + i * shentsize)
+    names_offset = section(shstrndx)[4]
+    for i in range(shnum):
+        name, _, _, _, offset, size = section(i)
+        if elf[names_offset + name:elf.index(b'\x00', names_offset + name)] == b'logfmt':
+            return elf[offset:offset + size]
+    raise ValueError(f"{path} has no logfmt section (built without LOG_DEFERRED?)")
+
+LOGFMT = load_logfmt(ARG_ELF) if ARG_ELF else None
+
+REGEX_PRINTF = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgG%])")
+
+def logbin_printf(fmt: str, rd: LogbinReader) -> str:
+    """printf on the host: arguments are read in the order of the conversions in fmt"""
+    out = []
+    last = 0
+    for m in REGEX_PRINTF.finditer(fmt):
+        flags, width, precision, length, conv = m.groups()
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        if conv == '%':
+            out.append('%')
+            continue
+        width = str(rd.int()) if width == '*' else (width or '')
+        precision = str(rd.int()) if precision == '*' else precision
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conv == 's':
+            out.append((spec + 's') % rd.str())
+        elif conv in 'fFeEgG':
+            out.append((spec + conv) % rd.double())
+        else:
+            value = rd.int()
+            bits = 64 if length in ('l', 'll', 'j', 'z', 't') else 32
+            if conv == 'p':
+                out.append('0x%x' % (value & 0xFFFFFFFFFFFFFFFF))
+            elif conv == 'c':
+                out.append((spec + 'c') % chr(value & 0xFF))
+            elif conv in 'di':
+                value = ((value + (1 << (bits - 1))) & ((1 << bits) - 1)) - (1 << (bits - 1))
+                out.append((spec + 'd') % value)
+            else:
+                out.append((spec + conv.replace('u', 'd')) % (value & ((1 << bits) - 1)))
+    out.append(fmt[last:])
+    return ''.join(out)
+
+# last full results per hart, for delta reports
+RESULTS_STATE = {}
+
+def results_crc(state: list) -> int:
+    words = [value for values in state for value in values]
+    return zlib.crc32(struct.pack(f"<{len(words)}I", *words))
+
+def logbin_render(record: bytes) -> str:
+    rtype, hart = record[0] >> 3, record[0] & 0x7
+    rd = LogbinReader(record[1:])
+    if rtype == LOGBIN_LIFECYCLE:
+        marker = rd.uint()
+        if marker == LOGBIN_MARK_INIT:
+            text = f"\n[INIT_HART{hart}]\n\n"
+        elif marker == LOGBIN_MARK_CYCLE_START:
+            text = f"[HART{hart}] [BENCHMARK_START] run_cycle: {rd.uint()}\n"
+        elif marker == LOGBIN_MARK_SCHEDULER:
+            text = f"[HART{hart}] [FREERTOS] Start scheduler \n"
+        elif marker in (LOGBIN_MARK_TASK_START, LOGBIN_MARK_TASK_END):
+            edge = "Start" if marker == LOGBIN_MARK_TASK_START else "End"
+            text = f"[HART{hart}] [FREERTOS] {edge} of: {rd.str()}\n"
+        else:
+            raise LogbinError(f"unknown lifecycle marker {marker}")
+    elif rtype in (LOGBIN_RESULTS, LOGBIN_RESULTS_DELTA):
+        cycle = rd.uint()
+        n = rd.uint()
+        if rtype == LOGBIN_RESULTS:
+            state = [[rd.uint() for _ in range(n)] for _ in range(3)]
+            # older firmware sends no CRC
+            crc = rd.uint() if rd.pos < len(rd.data) else None
+        else:
+            crc = rd.uint()
+            if (hart not in RESULTS_STATE) or (len(RESULTS_STATE[hart][0]) != n):
+                raise LogbinError(f"delta results of cycle {cycle} before a full report")
+            state = [list(values) for values in RESULTS_STATE[hart]]
+            for values in state:
+                for _ in range(rd.uint()):
+                    index = rd.uint()
+                    values[index] = rd.uint()
+        if (crc is not None) and (results_crc(state) != crc):
+            RESULTS_STATE.pop(hart, None)
+            raise LogbinError(f"results state CRC mismatch in cycle {cycle}")
+        RESULTS_STATE[hart] = state
+        errors, execs, runtime = state
+        text  = f"[HART{hart}] [BENCHMARK_END] embench_results: {cycle}\n"
+        text += f"[HART{hart}]   num_errors = [ {', '.join(map(str, errors))} ]\n"
+        text += f"[HART{hart}]   num_execs = [ {', '.join(map(str, execs))} ]\n"
+        text += f"[HART{hart}]   runtime (ms) = [ {', '.join(map(str, runtime))} ]\n\n"
+    elif rtype == LOGBIN_ERROR:
+        name = rd.str()
+        errnum = rd.uint()
+        itr = rd.uint()
+        text = f"\n[BENCHMARK_ERROR] {name}: errnum={errnum} itr={itr}{rd.str()}\n"
+    elif rtype == LOGBIN_TVS:
+        if rd.pos == len(rd.data):
+            text = f"[HART{hart}] [TVS] Reading TVS built-in sensor failed\n\n"
+        else:
+            volt_1v0, volt_1v8, volt_2v5, temperature = rd.uint(), rd.uint(), rd.uint(), rd.int()
+            text = f"[HART{hart}] [TVS] (volt_1v0 = {volt_1v0}mV) (volt_1v8 = {volt_1v8}mV) " + \
+                   f"(volt_2v5 = {volt_2v5}mV) (temp = {temperature}C)\n\n"
+    elif rtype == LOGBIN_TVS_STATS:
+        samples, failed = rd.uint(), rd.uint()
+        extra = ""
+        if samples:
+            low, mean, high = zip(*[(rd.int(), rd.int(), rd.int()) for _ in TVS_CHANNEL_NAMES])
+            text = f"[HART{hart}] [TVS] (volt_1v0 = {mean[0]}mV) (volt_1v8 = {mean[1]}mV) " + \
+                   f"(volt_2v5 = {mean[2]}mV) (temp = {mean[3]}C)\n"
+            extra = f" min=({', '.join(map(str, low))}) max=({', '.join(map(str, high))})"
+        else:
+            text = f"[HART{hart}] [TVS] Reading TVS built-in sensor failed\n"
+        crossings = rd.uint()
+        if crossings:
+            channel, value, stamp = rd.uint(), rd.int(), rd.int()
+            name = TVS_CHANNEL_NAMES[channel] if channel < len(TVS_CHANNEL_NAMES) else f"channel{channel}"
+            extra += f" first={name}:{value} mcycle=0x{stamp:016x}"
+        text += f"[HART{hart}] [TVS] interval: samples={samples} failed={failed} crossings={crossings}{extra}\n\n"
+    elif rtype == LOGBIN_HWERR:
+        text = ""
+        for _ in range(rd.uint()):
+            name, corrected, uncorrected, cause, addr = rd.str(), rd.uint(), rd.uint(), rd.uint(), rd.int()
+            text += f"[HART{hart}] [HWERR] {name}: corrected={corrected} uncorrected={uncorrected} " + \
+                    f"cause={cause} addr=0x{addr:016x}\n"
+    elif rtype == LOGBIN_TRACE:
+        ident = rd.uint()
+        header = f"[HART{hart}] " if ident & 1 else ""
+        ident >>= 1
+        if LOGFMT is None or ident >= len(LOGFMT):
+            text = f"{header}[TRACE] format {ident} unknown (monitor needs the ELF): {rd.data[rd.pos:].hex()}\n"
+            rd.pos = len(rd.data)
+        else:
+            fmt = LOGFMT[ident:LOGFMT.index(b'\x00', ident)].decode('utf-8', errors='replace')
+            text = header + logbin_printf(fmt, rd)
+            if not text.endswith('\n'):
+                text += '\n'
+    else:
+        raise LogbinError(f"unknown record type {rtype}")
+    if rd.pos != len(rd.data):
+        raise LogbinError("trailing bytes")
+    return text
+
+def decode_text_line(raw: bytes) -> str:
+    return ''.join(chr(byte) for byte in raw if byte < 0x80 and chr(byte).isprintable())
+
+def decode_output_line(raw: bytes) -> list:
+    """Returns [label, text] pairs for one line received from the UART (without the line break)"""
+    prefix = b''
+    if REGEX_TIMESTAMP.match(raw) and raw[9:10] == b'\x00':
+        prefix, raw = raw[:9], raw[9:]
+    if not raw.startswith(b'\x00'):
+        return [[ARG_LABEL, decode_text_line(prefix + raw)]]
+    try:
+        text = logbin_render(logbin_unframe(raw[1:]))
+    except (LogbinError, IndexError, ValueError, TypeError) as err:
+        return [['WARN', f"corrupted binary record ({err}): {(prefix + raw).hex()}"]]
+    prefix = prefix.decode('ascii')
+    return [[ARG_LABEL, prefix + line] for line in text.split('\n')[:-1]]
+
 ########################################################
 # LOGGING THREAD
 
@@ -244,22 +528,19 @@ def monitor_output():
     global finished, serial_device
     global logging_queue
     logging_queue.put([datetime.now(), 'INFO', "Listening serial..."])
-    line = ""
+    line = bytearray()
     try:
         last_print_time = None
         while not finished:
             dat = serial_device.read(1)
             if dat is not None and dat:
                 last_print_time = datetime.now()
-                try:
-                    dec = dat.decode('utf-8')
-                except UnicodeDecodeError as err:
-                    dec = 'x' + dat.hex().upper() + '\n'
-                if dec.isprintable():
-                    line += dec
-                if dec == '\n':
-                    logging_queue.put([datetime.now(), ARG_LABEL, line])
-                    line = ""
+                if dat != b'\n':
+                    line += dat
+                else:
+                    for label, text in decode_output_line(bytes(line)):
+                        logging_queue.put([datetime.now(), label, text])
+                    line = bytearray()
             elif last_print_time is not None and (datetime.now() - last_print_time) >= timedelta(minutes=2.5):
                     last_print_time = datetime.now()
                     logging_queue.put([last_print_time, 'WARN', ">=2.5 minutes without output"])
@@ -270,7 +551,7 @@ def monitor_output():
         finished = True
     finally:
         if line:
-            logging_queue.put([datetime.now(), f'{ARG_LABEL}-FIN', line])
+            logging_queue.put([datetime.now(), f'{ARG_LABEL}-FIN', decode_text_line(bytes(line))])
 
 if not ARG_ENABLE_LOOPBACK:
     read_thread = threading.Thread(